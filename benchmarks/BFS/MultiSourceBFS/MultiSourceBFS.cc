@@ -0,0 +1,86 @@
+// Usage:
+// numactl -i all ./MultiSourceBFS -num_sources 1024 -width 256 -s -m twitter_SJ
+// flags:
+//   optional:
+//     -num_sources : the total number of BFS sources (default 64)
+//     -width : sources traversed concurrently per batch, 64 or 256 (default 64)
+//     -seed : seed used to sample the sources (default 0)
+//     -rounds : the number of times to run the algorithm
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -s : indicate that the graph is symmetric
+//
+// Runs num_sources BFSs from uniformly random sources in batches of width
+// sources, and reports closeness and eccentricity aggregates (e.g., a lower
+// bound on the diameter).
+
+#include "MultiSourceBFS.h"
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("msbfs.txt");
+#endif
+
+template <class Bits, class Graph>
+void run_batches(Graph &G, const sequence<uintE> &sources,
+                 sequence<msbfs::source_stats> &stats) {
+    size_t width = Bits::kNumSources;
+    for (size_t start = 0; start < sources.size(); start += width) {
+        size_t end = std::min(start + width, sources.size());
+        auto batch = sequence<uintE>(end - start, [&](size_t i) {
+            return sources[start + i];
+        });
+        auto batch_stats = msbfs::MultiSourceBFSStats<Bits>(G, batch);
+        parallel_for(0, batch.size(),
+                     [&](size_t i) { stats[start + i] = batch_stats[i]; });
+    }
+}
+
+template <class Graph> double MultiSourceBFS_runner(Graph &G, commandLine P) {
+    size_t num_sources = P.getOptionLongValue("-num_sources", 64);
+    size_t width = P.getOptionLongValue("-width", 64);
+    size_t seed = P.getOptionLongValue("-seed", 0);
+    std::cout << "### Application: MultiSourceBFS" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -num_sources = " << num_sources
+              << " -width = " << width << " -seed = " << seed << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+    if (width != 64 && width != 256) {
+        std::cout << "# -width must be 64 or 256" << std::endl;
+        exit(-1);
+    }
+
+    auto r = pbbslib::random(seed);
+    auto sources = sequence<uintE>(
+        num_sources, [&](size_t i) { return r.ith_rand(i) % G.n; });
+    auto stats = sequence<msbfs::source_stats>(num_sources);
+
+    timer t;
+    t.start();
+    if (width == 64) {
+        run_batches<msbfs::bits64>(G, sources, stats);
+    } else {
+        run_batches<msbfs::bits256>(G, sources, stats);
+    }
+    double tt = t.stop();
+
+    auto ecc = pbbs::delayed_seq<size_t>(
+        num_sources, [&](size_t i) { return stats[i].eccentricity; });
+    auto reached = pbbs::delayed_seq<size_t>(
+        num_sources, [&](size_t i) { return stats[i].reached; });
+    std::cout << "### Max eccentricity (diameter lower bound): "
+              << pbbslib::reduce_max(ecc) << std::endl;
+    std::cout << "### Avg reached: "
+              << (double)pbbslib::reduce_add(reached) / num_sources
+              << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_main(gbbs::MultiSourceBFS_runner, false);
@@ -0,0 +1,241 @@
+#pragma once
+
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+namespace msbfs {
+
+// A set of BFS sources, one bit per source, supporting up to 64 * kWords
+// sources. All operations are fixed-length loops over the words, which the
+// compiler turns into vector instructions for the 256-source (kWords = 4)
+// variant.
+template <size_t kWords> struct alignas(8 * kWords) source_bits {
+    static constexpr size_t kNumSources = 64 * kWords;
+    uint64_t w[kWords];
+
+    source_bits() {
+        for (size_t i = 0; i < kWords; i++)
+            w[i] = 0;
+    }
+
+    // The set {0, ..., k-1}.
+    static source_bits prefix(size_t k) {
+        source_bits b;
+        for (size_t i = 0; i < kWords; i++) {
+            size_t lo = 64 * i;
+            if (k >= lo + 64) {
+                b.w[i] = ~((uint64_t)0);
+            } else if (k > lo) {
+                b.w[i] = (((uint64_t)1) << (k - lo)) - 1;
+            }
+        }
+        return b;
+    }
+
+    inline source_bits operator|(const source_bits &o) const {
+        source_bits b;
+        for (size_t i = 0; i < kWords; i++)
+            b.w[i] = w[i] | o.w[i];
+        return b;
+    }
+    inline source_bits &operator|=(const source_bits &o) {
+        for (size_t i = 0; i < kWords; i++)
+            w[i] |= o.w[i];
+        return *this;
+    }
+    // this \ o
+    inline source_bits and_not(const source_bits &o) const {
+        source_bits b;
+        for (size_t i = 0; i < kWords; i++)
+            b.w[i] = w[i] & ~o.w[i];
+        return b;
+    }
+    inline bool any() const {
+        uint64_t r = 0;
+        for (size_t i = 0; i < kWords; i++)
+            r |= w[i];
+        return r != 0;
+    }
+    // Is o a subset of this set?
+    inline bool contains(const source_bits &o) const {
+        return !o.and_not(*this).any();
+    }
+    inline void set(size_t i) { w[i / 64] |= ((uint64_t)1) << (i % 64); }
+    inline bool is_set(size_t i) const { return (w[i / 64] >> (i % 64)) & 1; }
+    inline size_t count() const {
+        size_t c = 0;
+        for (size_t i = 0; i < kWords; i++)
+            c += __builtin_popcountll(w[i]);
+        return c;
+    }
+    // Atomically ORs o into this set.
+    inline void atomic_or(const source_bits &o) {
+        for (size_t i = 0; i < kWords; i++) {
+            if (o.w[i] & ~w[i]) {
+                __sync_fetch_and_or(&w[i], o.w[i]);
+            }
+        }
+    }
+    // Applies f(i) to every source i in the set.
+    template <class F> inline void for_each(F f) const {
+        for (size_t i = 0; i < kWords; i++) {
+            uint64_t word = w[i];
+            while (word) {
+                f(64 * i + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+};
+
+// 64 and 256 concurrent sources.
+using bits64 = source_bits<1>;
+using bits256 = source_bits<4>;
+
+// visit[s] holds the sources whose BFS reached s in the previous level;
+// next[d] accumulates the sources reaching d in this level. A vertex is
+// emitted into the next frontier the first time any source reaches it.
+template <class W, class Bits> struct MSBFS_F {
+    Bits *seen;
+    Bits *visit;
+    Bits *next;
+    bool *touched;
+    Bits all;
+    MSBFS_F(Bits *seen, Bits *visit, Bits *next, bool *touched, Bits all)
+        : seen(seen), visit(visit), next(next), touched(touched), all(all) {}
+
+    // Even the non-atomic update can race on d: on compressed graphs a dense
+    // step decodes the neighbors of d in parallel blocks.
+    inline bool update(const uintE &s, const uintE &d, const W &wgh) {
+        return updateAtomic(s, d, wgh);
+    }
+    inline bool updateAtomic(const uintE &s, const uintE &d, const W &wgh) {
+        Bits b = visit[s].and_not(seen[d]);
+        if (!b.any())
+            return false;
+        next[d].atomic_or(b);
+        return !touched[d] &&
+               pbbslib::atomic_compare_and_swap(&touched[d], false, true);
+    }
+    // Stop pulling into d (or pushing to d) once every source has reached it.
+    inline bool cond(const uintE &d) const {
+        return !(seen[d] | next[d]).contains(all);
+    }
+};
+
+// Runs one BFS for each of the (at most Bits::kNumSources) sources
+// simultaneously, sharing every traversal of the graph across the batch.
+// Levels use the same dense/sparse switching as edgeMapData.
+//
+// visit_f(v, level, bits) is called (in parallel) once per vertex and level,
+// where bits is the set of source indices (positions in sources) whose BFS
+// first reaches v at distance level. level_f(level, frontier) is called once
+// per level after all of its visit_f calls, with the vertices reached at that
+// level. Returns the number of levels.
+template <class Bits, class Graph, class Visit, class Level>
+inline size_t MultiSourceBFS(Graph &G, const sequence<uintE> &sources,
+                             Visit visit_f, Level level_f) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    size_t k = sources.size();
+    assert(k <= Bits::kNumSources);
+
+    auto seen = sequence<Bits>(n, Bits());
+    auto visit = sequence<Bits>(n, Bits());
+    auto next = sequence<Bits>(n, Bits());
+    auto touched = sequence<bool>(n, false);
+    Bits all = Bits::prefix(k);
+
+    // Sources may repeat, so build the first frontier from the distinct ones.
+    auto distinct = sequence<uintE>(k);
+    size_t num_distinct = 0;
+    for (size_t i = 0; i < k; i++) {
+        uintE s = sources[i];
+        seen[s].set(i);
+        visit[s].set(i);
+        if (!touched[s]) {
+            touched[s] = true;
+            distinct[num_distinct++] = s;
+        }
+    }
+    auto first = sequence<uintE>(num_distinct, [&](size_t i) {
+        uintE s = distinct[i];
+        touched[s] = false;
+        visit_f(s, 0, visit[s]);
+        return s;
+    });
+
+    vertexSubset Frontier(n, std::move(first));
+    level_f(0, Frontier);
+    size_t level = 0;
+    while (!Frontier.isEmpty()) {
+        level++;
+        vertexSubset output = edgeMap(
+            G, Frontier,
+            MSBFS_F<W, Bits>(seen.begin(), visit.begin(), next.begin(),
+                             touched.begin(), all),
+            -1, sparse_blocked | dense_parallel);
+        vertexMap(Frontier, [&](const uintE &v) { visit[v] = Bits(); });
+        vertexMap(output, [&](const uintE &v) {
+            seen[v] |= next[v];
+            visit[v] = next[v];
+            next[v] = Bits();
+            touched[v] = false;
+            visit_f(v, level, visit[v]);
+        });
+        level_f(level, output);
+        Frontier.del();
+        Frontier = output;
+    }
+    Frontier.del();
+    return level;
+}
+
+template <class Bits, class Graph, class Visit>
+inline size_t MultiSourceBFS(Graph &G, const sequence<uintE> &sources,
+                             Visit visit_f) {
+    return MultiSourceBFS<Bits>(G, sources, visit_f,
+                                [](size_t, vertexSubset &) {});
+}
+
+// Per-source aggregates of a multi-source BFS: the number of vertices
+// reached, the sum of distances to them (for closeness), and the
+// eccentricity.
+struct source_stats {
+    size_t reached;
+    size_t distance_sum;
+    size_t eccentricity;
+};
+
+// Computes source_stats for every source using MultiSourceBFS. Each worker
+// accumulates into its own slots, so no atomics are needed on the per-source
+// counters.
+template <class Bits, class Graph>
+inline sequence<source_stats>
+MultiSourceBFSStats(Graph &G, const sequence<uintE> &sources) {
+    size_t k = sources.size();
+    size_t P = num_workers();
+    auto local = sequence<source_stats>(P * k, source_stats{0, 0, 0});
+    auto visit_f = [&](const uintE &v, size_t level, const Bits &bits) {
+        source_stats *mine = local.begin() + worker_id() * k;
+        bits.for_each([&](size_t i) {
+            mine[i].reached++;
+            mine[i].distance_sum += level;
+            mine[i].eccentricity = std::max(mine[i].eccentricity, level);
+        });
+    };
+    MultiSourceBFS<Bits>(G, sources, visit_f);
+    return sequence<source_stats>(k, [&](size_t i) {
+        source_stats s{0, 0, 0};
+        for (size_t p = 0; p < P; p++) {
+            auto &l = local[p * k + i];
+            s.reached += l.reached;
+            s.distance_sum += l.distance_sum;
+            s.eccentricity = std::max(s.eccentricity, l.eccentricity);
+        }
+        return s;
+    });
+}
+
+} // namespace msbfs
+} // namespace gbbs
@@ -0,0 +1,77 @@
+#include "benchmarks/BFS/MultiSourceBFS/MultiSourceBFS.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include "benchmarks/BFS/NonDeterministicBFS/BFS.h"
+#include "gbbs/edge_map_blocked.h"
+#include "gbbs/graph.h"
+#include "gbbs/graph_test_utils.h"
+#include "gbbs/macros.h"
+#include "gbbs/undirected_edge.h"
+#include "gtest/gtest.h"
+
+namespace gbbs {
+
+namespace {
+
+// The distances from source in the BFS tree given by parents.
+std::vector<size_t> DistancesFromParents(const pbbs::sequence<uintE> &parents,
+                                         uintE source) {
+    std::vector<size_t> distances(parents.size(), UINT_E_MAX);
+    for (size_t v = 0; v < parents.size(); v++) {
+        if (parents[v] == UINT_E_MAX) {
+            continue;
+        }
+        size_t d = 0;
+        for (uintE u = v; u != source; u = parents[u]) {
+            d++;
+        }
+        distances[v] = d;
+    }
+    return distances;
+}
+
+} // namespace
+
+TEST(MultiSourceBFS, MatchesSingleSourceBFS) {
+    // A sparse random graph with several components, and more sources than
+    // fit in one 64-bit word (including a repeated one).
+    constexpr uintE kNumVertices{1000};
+    std::unordered_set<UndirectedEdge> edges;
+    uint64_t state{1};
+    for (size_t i = 0; i < 1200; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uintE u = (state >> 33) % kNumVertices;
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uintE v = (state >> 33) % kNumVertices;
+        if (u != v) {
+            edges.insert(UndirectedEdge{u, v});
+        }
+    }
+    auto graph{graph_test::MakeUnweightedSymmetricGraph(kNumVertices, edges)};
+    // Sparse levels use sparse_blocked, which draws from the block allocator.
+    alloc_init(graph);
+
+    constexpr size_t kNumSources{150};
+    auto sources = pbbs::sequence<uintE>(
+        kNumSources, [](size_t i) { return (uintE)((7 * i) % kNumVertices); });
+    sources[kNumSources - 1] = sources[0];
+
+    std::vector<std::vector<size_t>> distances(
+        kNumSources, std::vector<size_t>(kNumVertices, UINT_E_MAX));
+    auto visit_f = [&](const uintE &v, size_t level,
+                       const msbfs::bits256 &bits) {
+        bits.for_each([&](size_t i) { distances[i][v] = level; });
+    };
+    msbfs::MultiSourceBFS<msbfs::bits256>(graph, sources, visit_f);
+
+    for (size_t i = 0; i < kNumSources; i++) {
+        auto parents = BFS(graph, sources[i]);
+        EXPECT_EQ(distances[i], DistancesFromParents(parents, sources[i]))
+            << "source index " << i;
+    }
+    alloc_finish();
+}
+
+} // namespace gbbs
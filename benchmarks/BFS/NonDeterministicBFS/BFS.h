@@ -24,6 +24,7 @@
 #pragma once
 
 #include "gbbs/gbbs.h"
+#include "gbbs/lazy_transpose.h"
 
 namespace gbbs {
 
@@ -179,4 +180,33 @@ inline sequence<uintE> BFS(asymmetric_graph<vertex, W> &G, uintE src) {
     return Parents;
 }
 
+// Direction-optimizing BFS over an asymmetric graph read without its
+// in-edges. The transpose is only materialized (built, or loaded from T's
+// cache file) the first time a dense, bottom-up step is chosen, so traversals
+// that stay sparse never pay for the in-edges.
+template <class W>
+inline sequence<uintE> BFS(asymmetric_graph<asymmetric_vertex, W> &G,
+                           uintE src, lazy_transpose<W> &T) {
+    /* Creates Parents array, initialized to all -1, except for src. */
+    auto Parents = sequence<uintE>(G.n, [&](size_t i) { return UINT_E_MAX; });
+    Parents[src] = src;
+
+    const flags fl = sparse_blocked | dense_parallel;
+    vertexSubset Frontier(G.n, src);
+    size_t reachable = 0;
+    while (!Frontier.isEmpty()) {
+        std::cout << Frontier.size() << "\n";
+        reachable += Frontier.size();
+        T.prepare(Frontier, -1, fl);
+        vertexSubset output =
+            neighbor_map(G, Frontier, BFS_F<W>(Parents.begin()), -1, fl);
+
+        Frontier.del();
+        Frontier = output;
+    }
+    Frontier.del();
+    std::cout << "Reachable: " << reachable << "\n";
+    return Parents;
+}
+
 } // namespace gbbs
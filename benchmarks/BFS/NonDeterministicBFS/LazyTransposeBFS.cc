@@ -0,0 +1,85 @@
+// This code is part of the project "Theoretically Efficient Parallel Graph
+// Algorithms Can Be Fast and Scalable", presented at Symposium on Parallelism
+// in Algorithms and Architectures, 2018.
+// Copyright (c) 2018 Laxman Dhulipala, Guy Blelloch, and Julian Shun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all  copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Usage:
+// numactl -i all ./LazyTransposeBFS -src 10012 -m -rounds 3
+//     -transpose_cache twitter_J.transpose twitter_J
+// flags:
+//   required:
+//     -src: the source to compute the BFS from
+//   optional:
+//     -rounds : the number of times to run the algorithm
+//     -m : indicate that the graph should be mmap'd
+//     -transpose_cache : file the transpose is loaded from if it exists, and
+//                        saved to after it is first built otherwise
+//
+// Runs direction-optimizing BFS on an (uncompressed, asymmetric) graph whose
+// in-edges are only materialized once the first dense step is chosen.
+
+#include "BFS.h"
+
+namespace gbbs {
+
+template <class Graph, class Transpose>
+double LazyTransposeBFS_runner(Graph &G, Transpose &T, commandLine P) {
+    uintE src = static_cast<uintE>(P.getOptionLongValue("-src", 0));
+    std::cout << "### Application: LazyTransposeBFS" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -src = " << src
+              << " -transpose_cache = " << T.cache_file << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+
+    timer t;
+    t.start();
+    auto parents = BFS(G, src, T);
+    double tt = t.stop();
+
+    std::cout << "### Transpose materialized: " << T.materialized
+              << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+} // namespace gbbs
+
+int main(int argc, char *argv[]) {
+    gbbs::commandLine P(argc, argv,
+                        " [-src s] [-transpose_cache <file>] <inFile>");
+    char *iFile = P.getArgument(0);
+    bool mmap = P.getOptionValue("-m");
+    std::string cache_file = P.getOptionValue("-transpose_cache", "");
+    size_t rounds = P.getOptionLongValue("-rounds", 3);
+    gbbs::pcm_init();
+    auto G = gbbs::gbbs_io::read_unweighted_asymmetric_out_graph(iFile, mmap);
+    gbbs::alloc_init(G);
+    // The transpose is shared across rounds: once built it stays in memory.
+    gbbs::lazy_transpose<pbbslib::empty> T(G, cache_file);
+    auto app = [&](auto &G, gbbs::commandLine P) {
+        return gbbs::LazyTransposeBFS_runner(G, T, P);
+    };
+    run_app(G, app, rounds)
+    gbbs::alloc_finish();
+}
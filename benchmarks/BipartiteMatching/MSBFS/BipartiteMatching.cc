@@ -0,0 +1,54 @@
+// Usage:
+// numactl -i all ./BipartiteMatching -s -nl 1000000 -rounds 3 bipartite_SJ
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//     -nl : the number of left vertices; vertices [0, nl) form the left side
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -check : check that the output is a valid matching
+//     -rounds : the number of times to run the algorithm
+
+#include "BipartiteMatching.h"
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("bipartite_matching.txt");
+#endif
+
+template <class Graph>
+double BipartiteMatching_runner(Graph &G, commandLine P) {
+    size_t num_left = P.getOptionLongValue("-nl", 0);
+    std::cout << "### Application: BipartiteMatching (MS-BFS)" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -nl = " << num_left << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+
+    assert(P.getOption("-s"));
+    if (num_left == 0 || num_left >= G.n) {
+        std::cout << "# -nl must be between 1 and n - 1" << std::endl;
+        exit(-1);
+    }
+    auto is_left = [num_left](uintE v) { return v < num_left; };
+
+    timer t;
+    t.start();
+    auto matching = BipartiteMatching(G, is_left);
+    double tt = t.stop();
+
+    std::cout << "### Matching size: " << matching.size() << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+    if (P.getOption("-check")) {
+        verify_bipartite_matching(G, is_left, matching);
+    }
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_symmetric_main(gbbs::BipartiteMatching_runner, false);
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "benchmarks/MaximalMatching/RandomGreedy/MaximalMatching.h"
+#include "gbbs/gbbs.h"
+
+// Maximum cardinality matching of a bipartite graph with multi-source BFS
+// augmenting paths (MS-BFS, as in Azad, Buluc and Pothen).
+//
+// The matching starts from a maximal matching (MaximalMatching, run on a copy
+// of the graph since it packs out edges). Every phase grows an alternating
+// BFS forest from all free left vertices at once with edgeMap, so the
+// traversal switches between sparse and dense steps as the frontier grows: a
+// left vertex visits its unvisited right neighbors, each right vertex joins
+// exactly one tree, and a matched right vertex passes the tree on to its
+// mate. A tree that reaches a free right vertex stops growing, and at the end
+// of the phase every such tree is augmented along its (vertex-disjoint) path
+// in parallel. Only trees that found a path are pruned, so a phase finds no
+// path exactly when the matching is maximum.
+//
+// The left side is given by a predicate on the vertex ids; edges with both
+// endpoints on the same side are ignored.
+namespace gbbs {
+namespace bipartite_matching {
+
+template <class W, class Left> struct ms_bfs_F {
+    uintE *mate;
+    uintE *parent; // right vertex -> left vertex that visited it
+    uintE *root;   // left vertex -> free left vertex at the root of its tree
+    uintE *leaf;   // root -> free right vertex that ends its path
+    Left &is_left;
+
+    ms_bfs_F(uintE *mate, uintE *parent, uintE *root, uintE *leaf,
+             Left &is_left)
+        : mate(mate), parent(parent), root(root), leaf(leaf),
+          is_left(is_left) {}
+
+    // Called once v has been claimed for s's tree.
+    inline bool visit(const uintE &s, const uintE &v) const {
+        uintE r = root[s];
+        if (mate[v] == UINT_E_MAX) {
+            pbbslib::atomic_compare_and_swap(&leaf[r], UINT_E_MAX, v);
+            return false;
+        }
+        root[mate[v]] = r;
+        return true;
+    }
+
+    inline bool update(const uintE &s, const uintE &d, const W &w) const {
+        if (leaf[root[s]] != UINT_E_MAX) {
+            return false;
+        }
+        parent[d] = s;
+        return visit(s, d);
+    }
+
+    inline bool updateAtomic(const uintE &s, const uintE &d,
+                             const W &w) const {
+        if (leaf[root[s]] != UINT_E_MAX ||
+            !pbbslib::atomic_compare_and_swap(&parent[d], UINT_E_MAX, s)) {
+            return false;
+        }
+        return visit(s, d);
+    }
+
+    inline bool cond(const uintE &d) const {
+        return !is_left(d) && parent[d] == UINT_E_MAX;
+    }
+};
+
+// Returns mate, where mate[v] is the vertex matched to v, or UINT_E_MAX.
+template <class Graph, class Left>
+inline sequence<uintE> InitialMatching(Graph &G, Left &is_left) {
+    using W = typename Graph::weight_type;
+    auto mate = sequence<uintE>(G.n, [](size_t i) { return UINT_E_MAX; });
+    auto crossing = [&](const uintE &u, const uintE &v, const W &w) {
+        return is_left(u) != is_left(v);
+    };
+    auto GC = filterGraph(G, crossing);
+    auto matching = MaximalMatching(GC);
+    GC.del();
+    par_for(0, matching.size(), [&](size_t i) {
+        uintE u = std::get<0>(matching[i]) & mm::VAL_MASK;
+        uintE v = std::get<1>(matching[i]);
+        mate[u] = v;
+        mate[v] = u;
+    });
+    return mate;
+}
+
+// Runs one phase on the free left vertices with neighbors, and returns the
+// number of augmenting paths found (and applied).
+template <class Graph, class Left>
+inline size_t AugmentPhase(Graph &G, Left &is_left, sequence<uintE> &mate,
+                           sequence<uintE> &parent, sequence<uintE> &root,
+                           sequence<uintE> &leaf) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    par_for(0, n, pbbslib::kSequentialForThreshold, [&](size_t i) {
+        parent[i] = UINT_E_MAX;
+        root[i] = i;
+        leaf[i] = UINT_E_MAX;
+    });
+    auto is_root = pbbs::delayed_seq<bool>(n, [&](size_t i) {
+        return is_left(i) && mate[i] == UINT_E_MAX &&
+               G.get_vertex(i).out_degree() > 0;
+    });
+    auto roots = pbbs::pack_index<uintE>(is_root);
+    if (roots.size() == 0) {
+        return 0;
+    }
+
+    auto F = ms_bfs_F<W, Left>(mate.begin(), parent.begin(), root.begin(),
+                               leaf.begin(), is_left);
+    auto sources =
+        sequence<uintE>(roots.size(), [&](size_t i) { return roots[i]; });
+    vertexSubset frontier(n, sources);
+    while (!frontier.isEmpty()) {
+        vertexSubset visited = edgeMap(G, frontier, F);
+        visited.toSparse();
+        // The mates of the visited (matched) right vertices, skipping trees
+        // that found a path in this step.
+        auto next = pbbs::filter(
+            pbbs::delayed_seq<uintE>(
+                visited.size(),
+                [&](size_t i) { return mate[visited.vtx(i)]; }),
+            [&](uintE u) { return leaf[root[u]] == UINT_E_MAX; });
+        visited.del();
+        frontier.del();
+        frontier = vertexSubset(n, next);
+    }
+    frontier.del();
+
+    auto augmented = pbbs::filter(
+        roots, [&](uintE r) { return leaf[r] != UINT_E_MAX; });
+    par_for(0, augmented.size(), [&](size_t i) {
+        uintE r = augmented[i];
+        uintE v = leaf[r];
+        while (true) {
+            uintE u = parent[v];
+            uintE next = mate[u];
+            mate[u] = v;
+            mate[v] = u;
+            if (u == r) {
+                break;
+            }
+            v = next;
+        }
+    });
+    return augmented.size();
+}
+
+} // namespace bipartite_matching
+
+// Returns a maximum matching of the bipartite graph G whose left vertices are
+// those for which is_left is true, as (left, right) pairs.
+template <class Graph, class Left>
+inline sequence<std::pair<uintE, uintE>> BipartiteMatching(Graph &G,
+                                                           Left is_left) {
+    size_t n = G.n;
+    timer init_t;
+    init_t.start();
+    auto mate = bipartite_matching::InitialMatching(G, is_left);
+    init_t.stop();
+    init_t.reportTotal("initial matching time");
+
+    auto parent = sequence<uintE>(n);
+    auto root = sequence<uintE>(n);
+    auto leaf = sequence<uintE>(n);
+    size_t phases = 0;
+    while (true) {
+        size_t augmented = bipartite_matching::AugmentPhase(
+            G, is_left, mate, parent, root, leaf);
+        phases++;
+        std::cout << "# phase " << phases << ": augmented " << augmented
+                  << " paths" << std::endl;
+        if (augmented == 0) {
+            break;
+        }
+    }
+
+    auto matched_left = pbbs::delayed_seq<bool>(
+        n, [&](size_t i) { return is_left(i) && mate[i] != UINT_E_MAX; });
+    auto left = pbbs::pack_index<uintE>(matched_left);
+    return sequence<std::pair<uintE, uintE>>(left.size(), [&](size_t i) {
+        return std::make_pair(left[i], mate[left[i]]);
+    });
+}
+
+// Checks that matching is a matching of G whose edges cross the bipartition.
+// Maximality of the size is not checked.
+template <class Graph, class Left, class Seq>
+inline bool verify_bipartite_matching(Graph &G, Left &is_left,
+                                      Seq &matching) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    auto count = sequence<uintE>(n, [](size_t i) { return 0; });
+    auto is_edge = sequence<bool>(matching.size());
+    par_for(0, matching.size(), [&](size_t i) {
+        uintE u = std::get<0>(matching[i]);
+        uintE v = std::get<1>(matching[i]);
+        pbbslib::write_add(&count[u], 1);
+        pbbslib::write_add(&count[v], 1);
+        auto find_f = [&](const uintE &src, const uintE &ngh, const W &wgh) {
+            return (size_t)(ngh == v);
+        };
+        auto monoid = pbbs::addm<size_t>();
+        is_edge[i] =
+            is_left(u) && !is_left(v) &&
+            G.get_vertex(u).out_neighbors().reduce(find_f, monoid) > 0;
+    });
+    size_t conflicts = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        n, [&](size_t i) { return (size_t)(count[i] > 1); }));
+    size_t non_edges = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        matching.size(), [&](size_t i) { return (size_t)!is_edge[i]; }));
+    if (conflicts > 0 || non_edges > 0) {
+        std::cout << "Matching invalid---" << conflicts
+                  << " vertices are matched more than once and " << non_edges
+                  << " pairs are not crossing edges." << std::endl;
+        return false;
+    }
+    std::cout << "Matching OK! matching size is: " << matching.size()
+              << std::endl;
+    return true;
+}
+
+} // namespace gbbs
@@ -88,6 +88,18 @@ template <class Graph> double AppKCore_runner(Graph &GA, commandLine P) {
     double approx_eps = P.getOptionDoubleValue(
         "--approxeps", 0.1); // epsilon for approximate vertex peeling
 
+    bool densest = P.getOption(
+        "--densest"); // if set, find an approximate k-clique densest subgraph
+    long densest_passes = P.getOptionLongValue(
+        "--passes", 20); // maximum number of Greedy++ passes for --densest
+    bool list = P.getOption(
+        "--list"); // if set, list the cliques instead of counting them
+    auto list_file = P.getOptionValue(
+        "--outfile", ""); // binary file for the listed cliques (k uintE
+                          // each), or text file for the densest subgraph
+    long list_buffer = P.getOptionLongValue(
+        "--buffer", 4096); // per-worker buffer for listing, in cliques
+
     // These are debugging options (set to correct defaults for client)
     long order = P.getOptionLongValue(
         "-o",
@@ -125,7 +137,32 @@ template <class Graph> double AppKCore_runner(Graph &GA, commandLine P) {
     t.start();
 
     size_t count = 0;
-    if (sparsify) {
+    if (densest) {
+        auto result = CliqueDensestSubgraph(GA, k, order, epsilon, space, label,
+                                            recursive_level, approx_eps,
+                                            densest_passes, &count);
+        std::cout << "densest subgraph: " << result.vertices.size()
+                  << " vertices, density " << result.density << std::endl;
+        if (!list_file.empty()) {
+            std::ofstream out(list_file);
+            for (size_t i = 0; i < result.vertices.size(); i++)
+                out << result.vertices[i] << "\n";
+        }
+    } else if (list) {
+        if (!list_file.empty()) {
+            clique_list::file_sink sink(list_file.c_str());
+            count = Clique_list(GA, k, order, epsilon, sink, list_buffer);
+        } else {
+            // Without a file, only consume the cliques.
+            size_t checksum = 0;
+            auto sink = [&](const uintE *cliques, size_t num, size_t k_) {
+                for (size_t i = 0; i < num * k_; i++)
+                    checksum += cliques[i];
+            };
+            count = Clique_list(GA, k, order, epsilon, sink, list_buffer);
+            std::cout << "checksum: " << checksum << std::endl;
+        }
+    } else if (sparsify) {
         // Sparsify graph, with random seed
         auto GA_sparse = clr_sparsify_graph(GA, sparsify_denom, 7398234);
 
@@ -46,6 +46,7 @@
 #include "induced_neighborhood.h"
 #include "induced_split.h"
 #include "intersect.h"
+#include "list.h"
 #include "peel.h"
 #include "relabel.h"
 
@@ -164,7 +165,8 @@ template <class Graph>
 inline size_t Clique(Graph &GA, size_t k, long order_type, double epsilon,
                      long space_type, bool label, bool filter, bool use_base,
                      long recursive_level, bool approx_peel,
-                     double approx_eps) {
+                     double approx_eps, size_t densest_passes = 1,
+                     densest_subgraph *densest = nullptr) {
     if (k < 3)
         ABORT("k must be >= 3: " << k);
 
@@ -248,10 +250,10 @@ inline size_t Clique(Graph &GA, size_t k, long order_type, double epsilon,
             Peel<uintE>(GA, DG, k - 1, per_vert, label, rank);
     } else {
         // Approximate vertex peeling
-        if (max_per_vert >= std::numeric_limits<uintE>::max())
-            ApproxPeel(GA, DG, k - 1, per_vert, count, label, rank, approx_eps);
-        else
-            ApproxPeel(GA, DG, k - 1, per_vert, count, label, rank, approx_eps);
+        auto result = ApproxPeel(GA, DG, k - 1, per_vert, label, rank,
+                                 approx_eps, densest_passes);
+        if (densest != nullptr)
+            *densest = std::move(result);
     }
 
     // Cleanup
@@ -261,4 +263,43 @@ inline size_t Clique(Graph &GA, size_t k, long order_type, double epsilon,
     return count;
 }
 
+// A k-clique densest subgraph of GA, by approximate peeling on the
+// per-vertex k-clique counts refined with up to max_passes Greedy++ passes
+// (see ApproxPeel); a single pass gives a k(1+approx_eps)-approximation. If
+// count is non-null, the number of k-cliques in GA is written to it.
+template <class Graph>
+inline densest_subgraph
+CliqueDensestSubgraph(Graph &GA, size_t k, long order_type, double epsilon,
+                      long space_type, bool label, long recursive_level,
+                      double approx_eps, size_t max_passes,
+                      size_t *count = nullptr) {
+    densest_subgraph densest;
+    size_t num_cliques =
+        Clique(GA, k, order_type, epsilon, space_type, label, true, true,
+               recursive_level, true, approx_eps, max_passes, &densest);
+    if (count != nullptr)
+        *count = num_cliques;
+    return densest;
+}
+
+// Lists the k-cliques of GA into sink (see clique_list::clique_buffers),
+// with the graph directed by the ordering of order_type as in Clique.
+// Returns the number of cliques.
+template <class Graph, class Sink>
+inline size_t Clique_list(Graph &GA, size_t k, long order_type, double epsilon,
+                          Sink &sink, size_t buffer_size) {
+    if (k < 2)
+        ABORT("k must be >= 2: " << k);
+    using W = typename Graph::weight_type;
+    sequence<uintE> rank = get_ordering(GA, order_type, epsilon);
+    auto pack_predicate = [&](const uintE &u, const uintE &v, const W &wgh) {
+        return (rank[u] < rank[v]) && GA.get_vertex(u).out_degree() >= k - 1 &&
+               GA.get_vertex(v).out_degree() >= k - 1;
+    };
+    auto DG = filterGraph(GA, pack_predicate);
+    size_t count = clique_list::ListCliques(DG, k, sink, buffer_size);
+    DG.del();
+    return count;
+}
+
 } // namespace gbbs
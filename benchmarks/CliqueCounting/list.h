@@ -0,0 +1,195 @@
+#pragma once
+
+#include <stdio.h>
+#include <mutex>
+#include <vector>
+
+#include "gbbs/gbbs.h"
+
+// Listing (as opposed to counting) of k-cliques. Cliques are written to
+// fixed-size per-worker buffers, and a full buffer is handed to a sink before
+// the worker continues, so at most num_workers() * buffer_size cliques are
+// held in memory at any time and a slow sink throttles the enumeration.
+namespace gbbs {
+namespace clique_list {
+
+// Writes cliques to a binary file as consecutive records of k uintE vertex
+// ids, in no particular order.
+struct file_sink {
+    FILE *f;
+    explicit file_sink(const char *path) : f(fopen(path, "wb")) {
+        if (f == nullptr) {
+            std::cout << "Unable to open file: " << path << std::endl;
+            exit(-1);
+        }
+    }
+    ~file_sink() { fclose(f); }
+    void operator()(const uintE *cliques, size_t num, size_t k) {
+        if (fwrite(cliques, sizeof(uintE), num * k, f) != num * k) {
+            std::cout << "Unable to write cliques" << std::endl;
+            exit(-1);
+        }
+    }
+};
+
+// Per-worker clique buffers in front of a sink. sink(cliques, num, k) is
+// called with num cliques of k vertices each, stored consecutively, and is
+// never called concurrently; the span is only valid during the call.
+template <class Sink> struct clique_buffers {
+    Sink &sink;
+    size_t k;
+    size_t capacity; // in cliques
+    std::vector<std::vector<uintE>> buffers;
+    std::mutex sink_lock;
+    size_t emitted;
+
+    clique_buffers(Sink &sink, size_t k, size_t capacity)
+        : sink(sink), k(k), capacity(std::max(capacity, (size_t)1)),
+          buffers(num_workers()), emitted(0) {
+        for (auto &b : buffers) {
+            b.reserve(this->capacity * k);
+        }
+    }
+
+    // Adds the clique of vertices c[0], ..., c[k-1].
+    inline void emit(const uintE *c) {
+        auto &b = buffers[worker_id()];
+        b.insert(b.end(), c, c + k);
+        if (b.size() == capacity * k) {
+            flush(b);
+        }
+    }
+
+    void flush(std::vector<uintE> &b) {
+        if (b.size() > 0) {
+            std::lock_guard<std::mutex> guard(sink_lock);
+            sink(b.data(), b.size() / k, k);
+            emitted += b.size() / k;
+        }
+        b.clear();
+    }
+
+    // Flushes the partially filled buffers; call once enumeration is done.
+    size_t finish() {
+        for (auto &b : buffers) {
+            flush(b);
+        }
+        return emitted;
+    }
+};
+
+namespace internal {
+// The out-neighbors of every vertex of a directed graph, decoded once and
+// sorted, so the recursion only intersects arrays.
+struct sorted_adjacency {
+    sequence<uintT> offsets;
+    sequence<uintE> edges;
+
+    template <class Graph> explicit sorted_adjacency(Graph &DG) {
+        using W = typename Graph::weight_type;
+        offsets = sequence<uintT>(DG.n + 1, [&](size_t i) {
+            return (i == DG.n) ? 0 : DG.get_vertex(i).out_degree();
+        });
+        size_t m = pbbslib::scan_add_inplace(offsets.slice());
+        edges = sequence<uintE>(m);
+        parallel_for(
+            0, DG.n,
+            [&](size_t i) {
+                uintE *out = edges.begin() + offsets[i];
+                auto map_f = [&](const uintE &u, const uintE &w, const W &wgh,
+                                 size_t j) { out[j] = w; };
+                DG.get_vertex(i).out_neighbors().map_with_index(map_f, false);
+                std::sort(out, out + (offsets[i + 1] - offsets[i]));
+            },
+            1);
+    }
+
+    inline const uintE *begin(uintE v) const {
+        return edges.begin() + offsets[v];
+    }
+    inline size_t degree(uintE v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+};
+
+inline void intersect(const uintE *A, size_t a, const uintE *B, size_t b,
+                      std::vector<uintE> &out) {
+    out.clear();
+    size_t i = 0, j = 0;
+    while (i < a && j < b) {
+        if (A[i] == B[j]) {
+            out.push_back(A[i]);
+            i++, j++;
+        } else if (A[i] < B[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+}
+
+// Scratch space of one worker: the clique being extended and the candidates
+// at every level below the first (whose candidates are the out-neighbors of
+// the source).
+struct list_space {
+    std::vector<uintE> clique;
+    std::vector<std::vector<uintE>> candidates;
+};
+
+// Extends S.clique (of size level) by every candidate at this level, given
+// as the array cand of size num_cand.
+template <class Buffers>
+inline void list_rec(const sorted_adjacency &A, const uintE *cand,
+                     size_t num_cand, size_t level, size_t k, list_space &S,
+                     Buffers &B) {
+    if (level + 1 == k) {
+        for (size_t i = 0; i < num_cand; i++) {
+            S.clique[level] = cand[i];
+            B.emit(S.clique.data());
+        }
+        return;
+    }
+    auto &next = S.candidates[level + 1];
+    for (size_t i = 0; i < num_cand; i++) {
+        uintE v = cand[i];
+        S.clique[level] = v;
+        intersect(cand, num_cand, A.begin(v), A.degree(v), next);
+        if (next.size() >= k - level - 1) {
+            list_rec(A, next.data(), next.size(), level + 1, k, S, B);
+        }
+    }
+}
+} // namespace internal
+
+// Lists every k-clique (k >= 2) of the directed acyclic graph DG, e.g. G
+// directed by a degree or degeneracy order (see get_ordering in Clique.h), in
+// which every clique is found exactly once, from its source. Returns the
+// number of cliques.
+template <class Graph, class Sink>
+inline size_t ListCliques(Graph &DG, size_t k, Sink &sink,
+                          size_t buffer_size = 4096) {
+    clique_buffers<Sink> B(sink, k, buffer_size);
+    internal::sorted_adjacency A(DG);
+    auto spaces = std::vector<internal::list_space>(num_workers());
+    for (auto &S : spaces) {
+        S.clique.resize(k);
+        S.candidates.resize(k);
+    }
+    parallel_for(
+        0, DG.n,
+        [&](size_t i) {
+            if (A.degree(i) + 1 < k) {
+                return;
+            }
+            // No parallelism below this point, so the worker (and its
+            // scratch space and buffer) stays the same.
+            auto &S = spaces[worker_id()];
+            S.clique[0] = i;
+            internal::list_rec(A, A.begin(i), A.degree(i), 1, k, S, B);
+        },
+        1);
+    return B.finish();
+}
+
+} // namespace clique_list
+} // namespace gbbs
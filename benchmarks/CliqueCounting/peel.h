@@ -553,25 +553,34 @@ sequence<bucket_t> Peel(Graph &G, Graph2 &DG, size_t k, size_t *cliques,
     return D;
 }
 
+// A vertex set and its k-clique density (number of k-cliques in the induced
+// subgraph divided by the number of vertices).
+struct densest_subgraph {
+    sequence<uintE> vertices;
+    double density;
+};
+
+// Approximate vertex peeling for the k-clique densest subgraph (k is the
+// number of vertices per clique minus one, as in Peel), refined by Greedy++
+// (Boob et al.; Chekuri, Quanrud and Torres for k-cliques). Each pass peels
+// the graph in rounds, removing every vertex whose load plus clique count is
+// at most (1+eps) times the average over the remaining vertices, and adds to
+// the load of each vertex its clique count when it is removed. The first pass
+// (all loads zero) is plain approximate peeling, whose densest remaining set
+// is a (k+1)(1+eps)-approximation; later passes move the peeling order
+// toward the optimum. Passes stop once one finds no denser set, or after
+// max_passes. cliques holds the per-vertex clique counts.
 template <class Graph, class Graph2>
-double ApproxPeel(Graph &G, Graph2 &DG, size_t k, size_t *cliques,
-                  size_t num_cliques, bool label, sequence<uintE> &rank,
-                  double eps) {
+densest_subgraph ApproxPeel(Graph &G, Graph2 &DG, size_t k, size_t *cliques,
+                            bool label, sequence<uintE> &rank, double eps,
+                            size_t max_passes = 1) {
     std::cout << "eps: " << eps << "\n";
     timer t2;
     t2.start();
     const size_t n = G.n;
-    auto D = sequence<size_t>(n, [&](size_t i) { return cliques[i]; });
-    auto vertices_remaining =
-        pbbs::delayed_seq<uintE>(n, [&](size_t i) { return i; });
-
-    size_t round = 1;
-    uintE *last_arr = nullptr;
-    size_t remaining_offset = 0;
-    size_t num_vertices_remaining = n;
-    double density_multiplier = (k + 1) * (1. + eps);
-
-    double max_density = 0.0;
+    auto D = sequence<size_t>(n);
+    auto load = sequence<size_t>(n, static_cast<size_t>(0));
+    auto removed_round = sequence<uintE>(n);
     char *still_active = (char *)calloc(n, sizeof(char));
     size_t max_deg = induced_hybrid::get_max_deg(G);
     auto per_processor_counts =
@@ -583,119 +592,126 @@ double ApproxPeel(Graph &G, Graph2 &DG, size_t k, size_t *cliques,
     };
     auto nop = [&](sequence<size_t> &ppc, size_t i, uintE v) { return; };
 
-    // First round
-    {
-        size_t edges_remaining = num_cliques;
-        // Update density
-        double current_density = ((double)edges_remaining) / ((double)(n));
-        double target_density =
-            (density_multiplier * ((double)edges_remaining)) /
-            ((double)vertices_remaining.size());
-        auto rho = target_density;
-        if (current_density > max_density)
-            max_density = current_density;
-
-        auto keep_seq = pbbs::delayed_seq<bool>(
-            n, [&](size_t i) { return !(D[i] <= target_density); });
-
-        auto split_vtxs_m = pbbs::split_two(vertices_remaining, keep_seq);
-        uintE *this_arr = split_vtxs_m.first.to_array();
-        size_t num_removed = split_vtxs_m.second;
-        size_t active_size = num_removed;
-
-        // remove this_arr vertices
-        // ************************************************
-        size_t granularity = (rho * active_size < 10000) ? 1024 : 1;
-        auto get_active = [&](size_t j) { return this_arr[j]; };
-        if (k == 2)
-            triUpdate(G, DG, get_active, active_size, granularity, still_active,
-                      rank, per_processor_counts, update_clique, false, nop);
-        else
-            cliqueUpdate(G, DG, k, max_deg, label, get_active, active_size,
-                         granularity, still_active, rank, per_processor_counts,
-                         update_clique, false, nop);
-        parallel_for(
-            0, active_size, [&](size_t j) { D[this_arr[j]] = 0; }, 2048);
-        //***************
-
-        round++;
-        last_arr = this_arr;
-        remaining_offset = num_removed;
-        num_vertices_remaining -= num_removed;
-    }
+    double max_density = 0.0;
+    sequence<uintE> densest;
+    size_t total_rounds = 0;
+    size_t pass = 0;
+    while (pass < std::max(max_passes, static_cast<size_t>(1))) {
+        parallel_for(0, n, [&](size_t i) {
+            D[i] = cliques[i];
+            still_active[i] = 0;
+        });
+        double pass_density = 0.0;
+        // The densest vertex set of this pass is the set of vertices still
+        // present at the start of round best_round.
+        size_t best_round = 1;
+        size_t round = 1;
+        uintE *last_arr = pbbs::new_array_no_init<uintE>(n);
+        parallel_for(0, n, [&](size_t i) { last_arr[i] = i; });
+        size_t remaining_offset = 0;
+        size_t num_vertices_remaining = n;
+
+        while (num_vertices_remaining > 0) {
+            uintE *start = last_arr + remaining_offset;
+            uintE *end = start + num_vertices_remaining;
+            auto vtxs_remaining = pbbs::make_range(start, end);
+
+            auto degree_f = [&](size_t i) {
+                uintE v = vtxs_remaining[i];
+                return static_cast<size_t>(D[v]);
+            };
+            auto degree_seq = pbbslib::make_sequence<size_t>(
+                vtxs_remaining.size(), degree_f);
+            size_t degrees_remaining = pbbslib::reduce_add(degree_seq);
+            auto load_f = [&](size_t i) { return load[vtxs_remaining[i]]; };
+            auto load_seq = pbbslib::make_sequence<size_t>(
+                vtxs_remaining.size(), load_f);
+            size_t load_remaining = pbbslib::reduce_add(load_seq);
+            // Every remaining clique is counted once by each of its k+1
+            // vertices.
+            size_t edges_remaining = degrees_remaining / (k + 1);
+
+            // Update density
+            double current_density =
+                ((double)edges_remaining) / ((double)vtxs_remaining.size());
+            double target_density =
+                ((1. + eps) * ((double)(degrees_remaining + load_remaining))) /
+                ((double)vtxs_remaining.size());
+            auto rho = target_density;
+            if (current_density > pass_density) {
+                pass_density = current_density;
+                best_round = round;
+            }
 
-    while (num_vertices_remaining > 0) {
-        uintE *start = last_arr + remaining_offset;
-        uintE *end = start + num_vertices_remaining;
-        auto vtxs_remaining = pbbs::make_range(start, end);
+            auto keep_seq =
+                pbbs::delayed_seq<bool>(vtxs_remaining.size(), [&](size_t i) {
+                    uintE v = vtxs_remaining[i];
+                    return !(load[v] + D[v] <= target_density);
+                });
 
-        auto degree_f = [&](size_t i) {
-            uintE v = vtxs_remaining[i];
-            return static_cast<size_t>(D[v]);
-        };
-        auto degree_seq =
-            pbbslib::make_sequence<size_t>(vtxs_remaining.size(), degree_f);
-        long edges_remaining = pbbslib::reduce_add(degree_seq);
-
-        // Update density
-        double current_density =
-            ((double)edges_remaining) / ((double)vtxs_remaining.size());
-        double target_density =
-            (density_multiplier * ((double)edges_remaining)) /
-            ((double)vtxs_remaining.size());
-        auto rho = target_density;
-        if (current_density > max_density)
-            max_density = current_density;
-
-        auto keep_seq =
-            pbbs::delayed_seq<bool>(vtxs_remaining.size(), [&](size_t i) {
-                return !(D[vtxs_remaining[i]] <= target_density);
-            });
-
-        auto split_vtxs_m = pbbs::split_two(vtxs_remaining, keep_seq);
-        uintE *this_arr = split_vtxs_m.first.to_array();
-        size_t num_removed = split_vtxs_m.second;
-
-        num_vertices_remaining -= num_removed;
-        if (num_vertices_remaining > 0) {
-            size_t active_size = num_removed;
-
-            // remove this_arr vertices
-            // ************************************************
-            size_t granularity = (rho * active_size < 10000) ? 1024 : 1;
-            auto get_active = [&](size_t j) { return this_arr[j]; };
-            if (k == 2)
-                triUpdate(G, DG, get_active, active_size, granularity,
-                          still_active, rank, per_processor_counts,
-                          update_clique, false, nop);
-            else
-                cliqueUpdate(G, DG, k, max_deg, label, get_active, active_size,
-                             granularity, still_active, rank,
-                             per_processor_counts, update_clique, false, nop);
+            auto split_vtxs_m = pbbs::split_two(vtxs_remaining, keep_seq);
+            uintE *this_arr = split_vtxs_m.first.to_array();
+            size_t num_removed = split_vtxs_m.second;
             parallel_for(
-                0, active_size, [&](size_t j) { D[this_arr[j]] = 0; }, 2048);
-            //***************
-        }
-
-        round++;
-        pbbs::free_array(last_arr);
-        last_arr = this_arr;
-        remaining_offset = num_removed;
-    }
+                0, num_removed,
+                [&](size_t j) {
+                    uintE v = this_arr[j];
+                    removed_round[v] = round;
+                    load[v] += D[v];
+                },
+                2048);
+
+            num_vertices_remaining -= num_removed;
+            if (num_vertices_remaining > 0) {
+                size_t active_size = num_removed;
+
+                // remove this_arr vertices
+                // ************************************************
+                size_t granularity = (rho * active_size < 10000) ? 1024 : 1;
+                auto get_active = [&](size_t j) { return this_arr[j]; };
+                if (k == 2)
+                    triUpdate(G, DG, get_active, active_size, granularity,
+                              still_active, rank, per_processor_counts,
+                              update_clique, false, nop);
+                else
+                    cliqueUpdate(G, DG, k, max_deg, label, get_active,
+                                 active_size, granularity, still_active, rank,
+                                 per_processor_counts, update_clique, false,
+                                 nop);
+                parallel_for(
+                    0, active_size, [&](size_t j) { D[this_arr[j]] = 0; },
+                    2048);
+                //***************
+            }
 
-    if (last_arr) {
+            round++;
+            pbbs::free_array(last_arr);
+            last_arr = this_arr;
+            remaining_offset = num_removed;
+        }
         pbbs::free_array(last_arr);
+        total_rounds += round - 1;
+        pass++;
+
+        if (pass > 1 && pass_density <= max_density)
+            break;
+        max_density = pass_density;
+        auto in_densest = pbbs::delayed_seq<bool>(
+            n, [&](size_t i) { return removed_round[i] >= best_round; });
+        densest = pbbs::pack_index<uintE>(in_densest);
     }
 
     double tt2 = t2.stop();
     std::cout << "### Peel Running Time: " << tt2 << std::endl;
-    std::cout << "rho: " << round << std::endl;
-    std::cout << "### Density of (2(1+\eps))-Densest Subgraph is: "
-              << max_density << std::endl;
+    std::cout << "rho: " << total_rounds << std::endl;
+    std::cout << "passes: " << pass << std::endl;
+    std::cout << "### Density of Densest Subgraph is: " << max_density
+              << std::endl;
+    std::cout << "### Densest Subgraph Size: " << densest.size() << std::endl;
 
     free(still_active);
 
-    return max_density;
+    return densest_subgraph{std::move(densest), max_density};
 }
 
 } // namespace gbbs
@@ -0,0 +1,67 @@
+// Usage:
+// numactl -i all ./Louvain -rounds 3 -s -m com-orkut.ungraph.txt_SJ
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -rounds : the number of times to run the algorithm
+//     -gamma : the resolution of the modularity objective (default 1)
+//     -louvain : contract the communities directly, without the Leiden
+//      refinement
+//     -levels : the maximum number of levels
+//     -iters : the maximum number of local moving rounds per level
+//     -seed : the random seed
+//     -outfile : write the community of every vertex, one per line
+
+#include "Louvain.h"
+
+#include <fstream>
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("louvain.txt");
+#endif
+
+template <class Graph> double Louvain_runner(Graph &G, commandLine P) {
+    louvain::params params;
+    params.resolution = P.getOptionDoubleValue("-gamma", 1.0);
+    params.refine = !P.getOption("-louvain");
+    params.max_levels = P.getOptionLongValue("-levels", 32);
+    params.max_rounds = P.getOptionLongValue("-iters", 64);
+    params.seed = P.getOptionLongValue("-seed", 0);
+    auto outfile = P.getOptionValue("-outfile", "");
+    std::cout << "### Application: Louvain (modularity clustering)"
+              << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -gamma = " << params.resolution
+              << " -refine = " << params.refine << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+    assert(P.getOption("-s"));
+
+    timer t;
+    t.start();
+    auto result = louvain::Louvain(G, params);
+    double tt = t.stop();
+
+    std::cout << "### Levels: " << result.levels << std::endl;
+    std::cout << "### Num communities: " << result.num_communities
+              << std::endl;
+    std::cout << "### Modularity: " << result.modularity << std::endl;
+    if (!outfile.empty()) {
+        std::ofstream out(outfile);
+        for (size_t i = 0; i < G.n; i++)
+            out << result.communities[i] << "\n";
+    }
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_symmetric_main(gbbs::Louvain_runner, false);
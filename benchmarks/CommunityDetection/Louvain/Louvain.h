@@ -0,0 +1,443 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "gbbs/contract.h"
+#include "gbbs/gbbs.h"
+
+// Parallel modularity clustering (Louvain, with the Leiden refinement).
+//
+// Every level runs synchronous local moving: in each round, the vertices of
+// the frontier pick the neighboring community with the largest modularity
+// gain against a snapshot of the community weights, and all moves are
+// applied at once. Only a random half of the frontier may move in a round,
+// which damps the oscillations of synchronous moves, and the next frontier
+// (computed with edgeMap) holds the neighbors of the vertices that moved and
+// the vertices that were not allowed to move.
+//
+// With refinement (Leiden), every community is then split into well-connected
+// subcommunities by merging singletons, in parallel, into the subcommunity of
+// the same community with the largest non-negative gain (the greedy variant
+// of the Leiden refinement). The graph is contracted on the subcommunities,
+// and the next level starts from the communities found at this level.
+// Without refinement (Louvain), the graph is contracted on the communities.
+//
+// Contraction uses the weighted contract::contract, which groups the edges
+// with an integer sort, so each level costs a constant number of sorts of its
+// edges on top of the local moving.
+namespace gbbs {
+namespace louvain {
+
+struct params {
+    double resolution = 1.0; // the gamma of generalized modularity
+    bool refine = true;      // Leiden refinement
+    size_t max_levels = 32;
+    size_t max_rounds = 64;    // local moving rounds per level
+    size_t refine_rounds = 16; // refinement rounds per level
+    size_t seed = 0;
+};
+
+// A clustering of the vertices with community ids in [0, num_communities).
+struct clustering {
+    sequence<uintE> communities;
+    size_t num_communities;
+    double modularity;
+    size_t levels;
+};
+
+using weighted_graph = symmetric_graph<symmetric_vertex, double>;
+
+namespace internal {
+
+template <class W> inline double weight_of(const W &w) {
+    if constexpr (std::is_same<W, pbbslib::empty>::value) {
+        return 1.0;
+    } else {
+        return static_cast<double>(w);
+    }
+}
+
+template <class Graph> inline sequence<double> weighted_degrees(Graph &G) {
+    using W = typename Graph::weight_type;
+    return sequence<double>(G.n, [&](size_t v) {
+        double d = 0;
+        auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+            d += weight_of(w);
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+        return d;
+    });
+}
+
+// (label, total edge weight from a vertex to the neighbors with that label)
+// for the labels around a vertex, sorted by label. One per worker.
+using label_weights = std::vector<std::pair<uintE, double>>;
+
+template <class Graph, class L, class Keep>
+inline void neighbor_weights(Graph &G, uintE v, const L &label, Keep keep,
+                             label_weights &out) {
+    using W = typename Graph::weight_type;
+    out.clear();
+    auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+        if (x != v && keep(x)) {
+            out.emplace_back(label[x], weight_of(w));
+        }
+    };
+    G.get_vertex(v).out_neighbors().map(map_f, false);
+    std::sort(out.begin(), out.end(),
+              [](const std::pair<uintE, double> &a,
+                 const std::pair<uintE, double> &b) {
+                  return a.first < b.first;
+              });
+    size_t k = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+        if (k > 0 && out[k - 1].first == out[i].first) {
+            out[k - 1].second += out[i].second;
+        } else {
+            out[k++] = out[i];
+        }
+    }
+    out.resize(k);
+}
+
+// Whether v may move in the given round; a pseudo-random half of the
+// vertices can in every round.
+inline bool can_move(uintE v, size_t round, size_t seed) {
+    return pbbs::hash64(pbbs::hash64(seed * 1000003 + round) + v) & 1;
+}
+
+template <class W> struct mark_F {
+    sequence<bool> &marked;
+    explicit mark_F(sequence<bool> &marked) : marked(marked) {}
+    inline bool update(const uintE &s, const uintE &d, const W &w) {
+        if (!marked[d]) {
+            marked[d] = true;
+            return true;
+        }
+        return false;
+    }
+    inline bool updateAtomic(const uintE &s, const uintE &d, const W &w) {
+        return pbbslib::atomic_compare_and_swap(&marked[d], false, true);
+    }
+    inline bool cond(const uintE &d) { return !marked[d]; }
+};
+
+// Local moving from the communities in comm (ids in [0, n)). deg holds the
+// vertex weights and m2 twice the total edge weight. Returns the number of
+// moves.
+template <class Graph>
+inline size_t LocalMoving(Graph &G, const sequence<double> &deg,
+                          sequence<uintE> &comm, double m2, const params &P,
+                          size_t level) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    auto tot = contract::cluster_sums<double>(comm, n, deg);
+    auto ones = pbbs::delayed_seq<intE>(n, [](size_t i) { return 1; });
+    auto size = contract::cluster_sums<intE>(comm, n, ones);
+    auto target = sequence<uintE>(n);
+    auto marked = sequence<bool>(n, false);
+    auto spaces = std::vector<label_weights>(num_workers());
+    size_t seed = pbbs::hash64(P.seed + level);
+
+    auto all = sequence<bool>(n, true);
+    auto vs = vertexSubset(n, all.to_array());
+    size_t moves = 0;
+    size_t round = 0;
+    for (; !vs.isEmpty() && round < P.max_rounds; round++) {
+        vs.toSparse();
+        size_t fs = vs.size();
+        parallel_for(
+            0, fs,
+            [&](size_t i) {
+                uintE v = vs.vtx(i);
+                uintE own = comm[v];
+                target[v] = own;
+                if (!can_move(v, round, seed)) {
+                    return;
+                }
+                auto &nw = spaces[worker_id()];
+                neighbor_weights(
+                    G, v, comm, [](uintE x) { return true; }, nw);
+                double scale = P.resolution * deg[v] / m2;
+                double best_gain = -scale * (tot[own] - deg[v]);
+                for (auto &[c, w] : nw) {
+                    if (c == own) {
+                        best_gain += w;
+                    }
+                }
+                uintE best = own;
+                for (auto &[c, w] : nw) {
+                    // Two singletons only merge towards the smaller id, so
+                    // that they do not swap.
+                    if (c == own || (size[own] == 1 && size[c] == 1 && c > own))
+                        continue;
+                    double gain = w - scale * tot[c];
+                    if (gain > best_gain) {
+                        best_gain = gain;
+                        best = c;
+                    }
+                }
+                target[v] = best;
+            },
+            1);
+
+        auto frontier = pbbs::delayed_seq<uintE>(
+            fs, [&](size_t i) { return vs.vtx(i); });
+        auto moved = pbbs::filter(
+            frontier, [&](uintE v) { return target[v] != comm[v]; });
+        auto waiting = pbbs::filter(
+            frontier, [&](uintE v) { return !can_move(v, round, seed); });
+        parallel_for(0, moved.size(), [&](size_t i) {
+            uintE v = moved[i];
+            pbbslib::write_add(&tot[comm[v]], -deg[v]);
+            pbbslib::write_add(&tot[target[v]], deg[v]);
+            pbbslib::write_add(&size[comm[v]], -1);
+            pbbslib::write_add(&size[target[v]], 1);
+            comm[v] = target[v];
+            marked[v] = true;
+        });
+        parallel_for(0, waiting.size(),
+                     [&](size_t i) { marked[waiting[i]] = true; });
+        moves += moved.size();
+
+        // The next frontier: the neighbors of the moved vertices, the moved
+        // vertices, and the vertices that could not move in this round.
+        size_t num_moved = moved.size();
+        auto moved_vs = vertexSubset(n, num_moved, moved.to_array());
+        auto next_vs = edgeMap(G, moved_vs, mark_F<W>(marked), -1,
+                               sparse_blocked | dense_forward);
+        next_vs.toSparse();
+        size_t num_next = next_vs.size();
+        size_t num_waiting = waiting.size();
+        auto next = sequence<uintE>(
+            num_next + num_moved + num_waiting, [&](size_t i) {
+                if (i < num_next)
+                    return next_vs.vtx(i);
+                if (i < num_next + num_moved)
+                    return moved_vs.vtx(i - num_next);
+                return waiting[i - num_next - num_moved];
+            });
+        parallel_for(0, next.size(),
+                     [&](size_t i) { marked[next[i]] = false; });
+        moved_vs.del();
+        next_vs.del();
+        vs.del();
+        vs = vertexSubset(n, next);
+    }
+    vs.del();
+    debug(std::cout << "# level " << level << ": " << round
+                    << " local moving rounds, " << moves << " moves"
+                    << std::endl;);
+    return moves;
+}
+
+// Leiden refinement of the communities in comm: returns a partition ref of
+// the vertices into subcommunities of the communities, each grown from a
+// singleton by merging well-connected singletons into it.
+template <class Graph>
+inline sequence<uintE> Refine(Graph &G, const sequence<double> &deg,
+                              const sequence<uintE> &comm, double m2,
+                              const params &P, size_t level) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    double gamma = P.resolution;
+    auto ref = sequence<uintE>(n, [&](size_t i) { return (uintE)i; });
+    auto rtot = sequence<double>(n, [&](size_t i) { return deg[i]; });
+    auto rsize = sequence<intE>(n, (intE)1);
+    auto ctot = contract::cluster_sums<double>(comm, n, deg);
+    // Weight between v and the rest of its community.
+    auto inside = sequence<double>(n, [&](size_t v) {
+        double d = 0;
+        auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+            if (x != v && comm[x] == comm[v])
+                d += weight_of(w);
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+        return d;
+    });
+    auto target = sequence<uintE>(n);
+    auto spaces = std::vector<label_weights>(num_workers());
+    size_t seed = pbbs::hash64(P.seed + level) + 1;
+
+    size_t idle = 0;
+    for (size_t round = 0; round < P.refine_rounds && idle < 2; round++) {
+        // Weight between each subcommunity and the rest of its community.
+        auto boundary = sequence<double>(n, [&](size_t v) {
+            double d = 0;
+            auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+                if (comm[x] == comm[v] && ref[x] != ref[v])
+                    d += weight_of(w);
+            };
+            G.get_vertex(v).out_neighbors().map(map_f, false);
+            return d;
+        });
+        auto outside = contract::cluster_sums<double>(ref, n, boundary);
+
+        parallel_for(
+            0, n,
+            [&](size_t i) {
+                uintE v = i;
+                target[v] = ref[v];
+                // Only singletons move, and a singleton that may move is not
+                // a target in the same round.
+                if (ref[v] != v || rsize[v] != 1 ||
+                    !can_move(v, round, seed)) {
+                    return;
+                }
+                uintE c = comm[v];
+                if (inside[v] < gamma * deg[v] * (ctot[c] - deg[v]) / m2) {
+                    return;
+                }
+                auto &nw = spaces[worker_id()];
+                neighbor_weights(
+                    G, v, ref, [&](uintE x) { return comm[x] == c; }, nw);
+                double best_gain = 0;
+                uintE best = v;
+                for (auto &[s, w] : nw) {
+                    if (rsize[s] == 1 && can_move(s, round, seed))
+                        continue;
+                    if (outside[s] < gamma * rtot[s] * (ctot[c] - rtot[s]) / m2)
+                        continue;
+                    double gain = w - gamma * deg[v] * rtot[s] / m2;
+                    if (gain > best_gain) {
+                        best_gain = gain;
+                        best = s;
+                    }
+                }
+                target[v] = best;
+            },
+            1);
+
+        auto moved = pbbs::pack_index<uintE>(pbbs::delayed_seq<bool>(
+            n, [&](size_t v) { return target[v] != ref[v]; }));
+        parallel_for(0, moved.size(), [&](size_t i) {
+            uintE v = moved[i];
+            uintE s = target[v];
+            pbbslib::write_add(&rtot[s], deg[v]);
+            pbbslib::write_add(&rsize[s], 1);
+            rtot[v] = 0;
+            rsize[v] = 0;
+            ref[v] = s;
+        });
+        idle = (moved.size() == 0) ? idle + 1 : 0;
+    }
+    return ref;
+}
+
+// Local moving, refinement and contraction of one level. Returns false if
+// the level could not be contracted any further; otherwise G_next, deg and
+// comm describe the next level, and assignment maps the input vertices to
+// the vertices of G_next.
+template <class Graph>
+inline bool Level(Graph &G, sequence<double> &deg, sequence<uintE> &comm,
+                  sequence<uintE> &assignment, double m2, const params &P,
+                  size_t level, weighted_graph &G_next) {
+    size_t n = G.n;
+    LocalMoving(G, deg, comm, m2, P, level);
+
+    auto clusters = P.refine ? Refine(G, deg, comm, m2, P, level) : comm;
+    size_t num_clusters = contract::RelabelIds(clusters);
+    if (num_clusters == n && P.refine) {
+        // No singleton could be merged; contract the communities instead.
+        clusters = comm;
+        num_clusters = contract::RelabelIds(clusters);
+    }
+    if (num_clusters == n) {
+        return false;
+    }
+
+    auto weight = [&](const typename Graph::weight_type &w) {
+        return weight_of(w);
+    };
+    G_next = contract::contract(G, clusters, num_clusters, weight,
+                                pbbs::addm<double>())
+                 .first;
+    auto next_deg =
+        contract::cluster_sums<double>(clusters, num_clusters, deg);
+    // The next level starts from the communities of this level (which are
+    // unions of clusters).
+    auto communities = comm;
+    contract::RelabelIds(communities);
+    auto next_comm = sequence<uintE>(num_clusters);
+    parallel_for(0, n,
+                 [&](size_t v) { next_comm[clusters[v]] = communities[v]; });
+    parallel_for(0, assignment.size(),
+                 [&](size_t i) { assignment[i] = clusters[assignment[i]]; });
+    deg = std::move(next_deg);
+    comm = std::move(next_comm);
+    return true;
+}
+
+} // namespace internal
+
+// The modularity of a clustering of G with the given resolution.
+template <class Graph>
+inline double Modularity(Graph &G, const sequence<uintE> &communities,
+                         size_t num_communities, double resolution = 1.0) {
+    using W = typename Graph::weight_type;
+    auto deg = internal::weighted_degrees(G);
+    double m2 = pbbslib::reduce_add(deg);
+    if (m2 == 0) {
+        return 0;
+    }
+    auto inside = pbbs::delayed_seq<double>(G.n, [&](size_t v) {
+        double d = 0;
+        auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+            if (communities[x] == communities[v])
+                d += internal::weight_of(w);
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+        return d;
+    });
+    auto tot =
+        contract::cluster_sums<double>(communities, num_communities, deg);
+    auto squares = pbbs::delayed_seq<double>(num_communities, [&](size_t c) {
+        return (tot[c] / m2) * (tot[c] / m2);
+    });
+    return pbbslib::reduce_add(inside) / m2 -
+           resolution * pbbslib::reduce_add(squares);
+}
+
+// Clusters the vertices of the symmetric graph G, treating an unweighted
+// graph as having unit weights.
+template <class Graph>
+inline clustering Louvain(Graph &G, const params &P = params()) {
+    size_t n = G.n;
+    auto assignment = sequence<uintE>(n, [&](size_t i) { return (uintE)i; });
+    auto deg = internal::weighted_degrees(G);
+    double m2 = pbbslib::reduce_add(deg);
+    auto comm = sequence<uintE>(n, [&](size_t i) { return (uintE)i; });
+
+    size_t levels = 0;
+    if (m2 > 0) {
+        weighted_graph GC;
+        bool more = internal::Level(G, deg, comm, assignment, m2, P, 0, GC);
+        levels++;
+        while (more && levels < P.max_levels) {
+            weighted_graph G_next;
+            more = internal::Level(GC, deg, comm, assignment, m2, P, levels,
+                                   G_next);
+            levels++;
+            GC.del();
+            if (more) {
+                GC = std::move(G_next);
+            }
+        }
+        if (more) {
+            GC.del();
+        }
+    }
+
+    auto communities = sequence<uintE>(
+        n, [&](size_t i) { return comm[assignment[i]]; });
+    size_t num_communities = contract::RelabelIds(communities);
+    double modularity =
+        Modularity(G, communities, num_communities, P.resolution);
+    return clustering{std::move(communities), num_communities, modularity,
+                      levels};
+}
+
+} // namespace louvain
+} // namespace gbbs
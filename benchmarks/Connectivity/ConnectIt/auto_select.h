@@ -0,0 +1,181 @@
+#pragma once
+
+#include "framework.h"
+
+// A single connectivity entry point that picks the ConnectIt variant from
+// cheap statistics of the input instead of offline benchmarking:
+//
+//  * k-out sampling is run first (it is cheap and usually finds the massive
+//    component); if its most frequent component covers at least
+//    -auto_coverage of the vertices, the sample is kept and finished.
+//  * Otherwise a BFS from the highest-degree vertex, capped at
+//    -auto_bfs_rounds rounds, samples the diameter (the eccentricity of the
+//    source, a lower bound). If it finished within the cap and covers enough
+//    of the graph, it is kept as the sample; if it was capped, the graph has
+//    a high diameter and the BFS sample is abandoned.
+//  * If neither sample covers enough of the graph, the residual left to the
+//    finish algorithm would be large, so sampling is abandoned.
+//
+// The finish algorithm is union-find with Rem-CAS and SplitAtomicOne. After a
+// successful sample almost every find ends at the skipped component right
+// away, so finds do no compression; without sampling, trees are built from
+// scratch and finds compress the paths they traverse.
+//
+// LDD sampling and the other finish algorithms are not chosen: on the graphs
+// where both samples above fail, LDD sampling was slower than no sampling,
+// and Liu-Tarjan (without the edge-list conversion of its alter variants)
+// was slower than union-find.
+namespace gbbs {
+namespace connectit {
+
+struct graph_stats {
+    double kout_coverage; // fraction in the most frequent k-out component
+    bool probed = false;  // whether the BFS probe ran
+    size_t diameter = 0;  // eccentricity of the BFS probe's source
+    bool capped = false;  // whether the probe stopped at the round limit
+    double bfs_coverage = 0;
+};
+
+struct variant {
+    SamplingOption sampling;
+    FindOption find;
+};
+
+namespace auto_select {
+
+// Hands out precomputed initial components, so that the sample taken while
+// estimating statistics is not computed twice.
+struct precomputed_sampler {
+    pbbs::sequence<parent> parents;
+    pbbs::sequence<parent> initial_components() { return std::move(parents); }
+};
+
+// BFS from src for at most max_rounds rounds. Returns the labeling of
+// BFS_ComponentLabel restricted to the vertices reached, which is a valid
+// (partial) component labeling, and sets the eccentricity of src (or
+// max_rounds, if capped), whether the BFS was capped, and the number of
+// vertices reached.
+template <class Graph>
+inline pbbs::sequence<parent> CappedBFS(Graph &G, uintE src, size_t max_rounds,
+                                        size_t &eccentricity, bool &capped,
+                                        size_t &reached) {
+    using W = typename Graph::weight_type;
+    auto parents = pbbs::sequence<parent>(G.n, [&](size_t i) { return i; });
+    vertexSubset frontier(G.n, src);
+    eccentricity = 0;
+    while (eccentricity < max_rounds) {
+        vertexSubset output = edgeMap(
+            G, frontier, BFS_ComponentLabel_F<W>(parents.begin(), src), -1,
+            sparse_blocked | dense_parallel);
+        frontier.del();
+        frontier = output;
+        if (frontier.isEmpty()) {
+            break;
+        }
+        eccentricity++;
+    }
+    capped = !frontier.isEmpty();
+    frontier.del();
+    // Counted from the labels: the source passes cond() and may reappear in
+    // later frontiers.
+    reached = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        G.n, [&](size_t i) { return (size_t)(parents[i] == src); }));
+    return parents;
+}
+
+template <class Graph, SamplingOption sampling_option, FindOption find_option>
+pbbs::sequence<parent> Finish(Graph &G, pbbs::sequence<parent> &&parents) {
+    auto find = get_find_function<find_option>();
+    auto splice = get_splice_function<split_atomic_one>();
+    auto unite = get_unite_function<unite_rem_cas, decltype(find),
+                                    decltype(splice), find_option>(G.n, find,
+                                                                   splice);
+    using UF = union_find::UFAlgorithm<decltype(find), decltype(unite), Graph>;
+    auto alg = UF(G, unite, find);
+    if constexpr (sampling_option == no_sampling) {
+        auto connectivity =
+            NoSamplingAlgorithmTemplate<Graph, UF, union_find_type>(G, alg);
+        return connectivity.components();
+    } else {
+        auto sample = precomputed_sampler{std::move(parents)};
+        auto connectivity =
+            SamplingAlgorithmTemplate<Graph, precomputed_sampler, UF,
+                                      union_find_type, sampling_option>(
+                G, sample, alg);
+        return connectivity.components();
+    }
+}
+
+inline void log_choice(const graph_stats &S, const variant &V) {
+    std::cout << "# auto: k-out coverage = " << S.kout_coverage;
+    if (S.probed) {
+        std::cout << ", sampled diameter >= " << S.diameter
+                  << (S.capped ? " (capped)" : "")
+                  << ", bfs coverage = " << S.bfs_coverage;
+    }
+    std::cout << std::endl;
+    std::cout << "# auto: chose "
+              << uf_options_to_string(V.sampling, V.find, unite_rem_cas,
+                                      split_atomic_one)
+              << std::endl;
+}
+
+} // namespace auto_select
+
+// Computes the connected components of G with the variant chosen as described
+// at the top of the file. If V is not null, the chosen variant is stored in
+// it.
+template <class Graph>
+pbbs::sequence<parent> AutoConnectivity(Graph &G, commandLine &P,
+                                        variant *V = nullptr) {
+    size_t n = G.n;
+    double min_coverage = P.getOptionDoubleValue("-auto_coverage", 0.5);
+    size_t max_rounds = P.getOptionLongValue(
+        "-auto_bfs_rounds", 4 * pbbs::log2_up(std::max(n, (size_t)2)));
+    if (n == 0) {
+        // The samplers assume at least one vertex.
+        return pbbs::sequence<parent>();
+    }
+
+    graph_stats S;
+    using degree_pair = std::pair<uintE, uintE>;
+    auto degrees = pbbs::delayed_seq<degree_pair>(n, [&](size_t i) {
+        return std::make_pair((uintE)G.get_vertex(i).out_degree(), (uintE)i);
+    });
+    uintE hub = pbbs::reduce(degrees, pbbs::maxm<degree_pair>()).second;
+
+    auto kout = KOutSamplingTemplate<Graph>(G, P);
+    auto parents = kout.initial_components();
+    S.kout_coverage = connectit::sample_frequent_element(parents).second;
+
+    variant choice{sample_kout, find_naive};
+    if (S.kout_coverage < min_coverage) {
+        choice = variant{no_sampling, find_compress};
+        size_t reached;
+        auto bfs = auto_select::CappedBFS(G, hub, max_rounds, S.diameter,
+                                          S.capped, reached);
+        S.probed = true;
+        S.bfs_coverage = (double)reached / n;
+        if (!S.capped && S.bfs_coverage >= min_coverage) {
+            parents = std::move(bfs);
+            choice = variant{sample_bfs, find_naive};
+        }
+    }
+    auto_select::log_choice(S, choice);
+    if (V != nullptr) {
+        *V = choice;
+    }
+
+    if (choice.sampling == sample_kout) {
+        return auto_select::Finish<Graph, sample_kout, find_naive>(
+            G, std::move(parents));
+    } else if (choice.sampling == sample_bfs) {
+        return auto_select::Finish<Graph, sample_bfs, find_naive>(
+            G, std::move(parents));
+    }
+    return auto_select::Finish<Graph, no_sampling, find_compress>(
+        G, std::move(parents));
+}
+
+} // namespace connectit
+} // namespace gbbs
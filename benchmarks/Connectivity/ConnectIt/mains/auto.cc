@@ -0,0 +1,71 @@
+// Usage:
+// ./auto -s -r 3 -check <graph>
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -r : the number of times to run the algorithm
+//     -check : check the components against work-efficient connectivity
+//     -auto_coverage : the fraction of the vertices a sample must cover for
+//        it to be used (default 0.5)
+//     -auto_bfs_rounds : the round limit of the BFS sample
+//        (default 4 log n)
+//     -sample_rounds : the number of k-out sampling rounds (default 2)
+//     -index : write the component index of the result to this file
+
+#include "benchmarks/Connectivity/BFSCC/Connectivity.h"
+#include "benchmarks/Connectivity/ConnectIt/auto_select.h"
+#include "benchmarks/Connectivity/WorkEfficientSDB14/Connectivity.h"
+#include "benchmarks/Connectivity/common.h"
+#include "benchmarks/Connectivity/component_index.h"
+
+#include "bench_utils.h"
+
+namespace gbbs {
+namespace connectit {
+
+// Runs AutoConnectivity rounds times, and keeps the labels of the last run
+// in labels.
+template <class Graph>
+void auto_cc(Graph &G, int rounds, commandLine &P,
+             pbbs::sequence<parent> &correct, pbbs::sequence<parent> &labels) {
+    auto test = [&](Graph &graph, commandLine params,
+                    pbbs::sequence<parent> &correct_cc) {
+        time(t, auto CC = AutoConnectivity(graph, params));
+        if (params.getOptionValue("-check")) {
+            cc_check(correct_cc, CC);
+        }
+        labels = std::move(CC);
+        return t;
+    };
+    run_multiple(G, rounds, correct, "auto", P, test);
+}
+
+} // namespace connectit
+
+template <class Graph> double Benchmark_runner(Graph &G, commandLine P) {
+    int rounds = P.getOptionIntValue("-r", 5);
+
+    auto correct = pbbs::sequence<parent>();
+    if (P.getOptionValue("-check")) {
+        correct = workefficient_cc::CC(G, 0.2, false, true);
+        RelabelDet(correct);
+    }
+    auto labels = pbbs::sequence<parent>();
+    connectit::auto_cc(G, rounds, P, correct, labels);
+
+    auto index_file = P.getOptionValue("-index");
+    if (index_file) {
+        auto index = BuildComponentIndex(labels);
+        auto histogram = index.size_histogram();
+        size_t largest =
+            (histogram.size() == 0) ? 0 : histogram[histogram.size() - 1].first;
+        std::cout << "### Components: " << index.num_components << std::endl;
+        std::cout << "### Largest component: " << largest << std::endl;
+        index.write(index_file);
+    }
+    return 1.0;
+}
+} // namespace gbbs
+
+generate_symmetric_once_main(gbbs::Benchmark_runner, false);
@@ -0,0 +1,174 @@
+// Compact, queryable connectivity output.
+//
+// The connectivity algorithms return a parent array of raw representative
+// ids. component_index compresses it to dense component ids in [0, k),
+// groups the vertices by component in CSR form, and answers component_of and
+// connected in O(1), one at a time or in parallel batches. It can be written
+// to a file and read back without recomputing anything.
+//
+// File layout (all fields native-endian):
+//   component_index_header
+//   uintE component[n]
+//   uintT offsets[k + 1]
+//   uintE members[n]
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include "benchmarks/Connectivity/common.h"
+#include "gbbs/contract.h"
+#include "gbbs/gbbs.h"
+#include "gbbs/io.h"
+#include "pbbslib/integer_sort.h"
+#include "pbbslib/sample_sort.h"
+
+namespace gbbs {
+
+struct component_index_header {
+    uint64_t magic;
+    uint64_t n;
+    uint64_t num_components;
+};
+
+// "gbbsCMP1" in ASCII.
+constexpr uint64_t kComponentIndexMagic = 0x31504d4373626267ULL;
+
+struct component_index {
+    size_t num_components = 0;
+    sequence<uintE> component; // component id of every vertex, in [0, k)
+    sequence<uintT> offsets;   // members of c: [offsets[c], offsets[c + 1])
+    sequence<uintE> members;   // vertices grouped by component, increasing
+
+    size_t num_vertices() const { return component.size(); }
+
+    uintE component_of(uintE v) const { return component[v]; }
+
+    bool connected(uintE u, uintE v) const {
+        return component[u] == component[v];
+    }
+
+    size_t component_size(uintE c) const { return offsets[c + 1] - offsets[c]; }
+
+    // The vertices of component c, in increasing order.
+    range<uintE *> component_members(uintE c) const {
+        return members.slice(offsets[c], offsets[c + 1]);
+    }
+
+    // Batched lookups: plain gathers, run in parallel over the batch.
+    template <class Seq>
+    sequence<uintE> components_of(const Seq &vertices) const {
+        return sequence<uintE>(vertices.size(), [&](size_t i) {
+            return component[vertices[i]];
+        });
+    }
+
+    // queries[i] is a pair (u, v).
+    template <class Seq> sequence<bool> connected(const Seq &queries) const {
+        return sequence<bool>(queries.size(), [&](size_t i) {
+            return component[std::get<0>(queries[i])] ==
+                   component[std::get<1>(queries[i])];
+        });
+    }
+
+    // (size, number of components of that size) pairs, by increasing size.
+    sequence<std::pair<size_t, size_t>> size_histogram() const {
+        size_t k = num_components;
+        auto sizes = sequence<size_t>(
+            k, [&](size_t c) { return component_size(c); });
+        pbbs::sample_sort_inplace(sizes.slice(), std::less<size_t>());
+        auto is_start = pbbs::delayed_seq<bool>(k, [&](size_t i) {
+            return i == 0 || sizes[i] != sizes[i - 1];
+        });
+        auto starts = pbbs::pack_index<size_t>(is_start);
+        return sequence<std::pair<size_t, size_t>>(
+            starts.size(), [&](size_t i) {
+                size_t end = (i + 1 == starts.size()) ? k : starts[i + 1];
+                return std::make_pair(sizes[starts[i]], end - starts[i]);
+            });
+    }
+
+    bool write(const std::string &path) const {
+        std::ofstream out(path, std::ios::out | std::ios::binary);
+        if (!out.is_open()) {
+            std::cout << "# unable to write component index " << path
+                      << std::endl;
+            return false;
+        }
+        size_t n = num_vertices();
+        component_index_header header = {kComponentIndexMagic, n,
+                                         num_components};
+        out.write((char *)&header, sizeof(header));
+        out.write((char *)component.begin(), n * sizeof(uintE));
+        out.write((char *)offsets.begin(),
+                  (num_components + 1) * sizeof(uintT));
+        out.write((char *)members.begin(), n * sizeof(uintE));
+        out.close();
+        return true;
+    }
+
+    bool read(const std::string &path) {
+        char *bytes;
+        size_t bytes_size;
+        std::tie(bytes, bytes_size) = gbbs_io::mmapStringFromFile(path.c_str());
+        auto header = (component_index_header *)bytes;
+        if (bytes_size < sizeof(component_index_header) ||
+            header->magic != kComponentIndexMagic ||
+            bytes_size != sizeof(component_index_header) +
+                              (2 * header->n) * sizeof(uintE) +
+                              (header->num_components + 1) * sizeof(uintT)) {
+            std::cout << "# " << path << " is not a component index"
+                      << std::endl;
+            gbbs_io::unmmap(bytes, bytes_size);
+            return false;
+        }
+        size_t n = header->n;
+        num_components = header->num_components;
+        auto component_arr = (uintE *)(bytes + sizeof(component_index_header));
+        auto offsets_arr = (uintT *)(component_arr + n);
+        auto members_arr = (uintE *)(offsets_arr + (num_components + 1));
+        component =
+            sequence<uintE>(n, [&](size_t i) { return component_arr[i]; });
+        offsets = sequence<uintT>(num_components + 1,
+                                  [&](size_t i) { return offsets_arr[i]; });
+        members = sequence<uintE>(n, [&](size_t i) { return members_arr[i]; });
+        gbbs_io::unmmap(bytes, bytes_size);
+        return true;
+    }
+};
+
+// Builds the index of the components given by parents, a parent forest whose
+// trees are the components (roots point to themselves), as returned by the
+// ConnectIt algorithms; the trees need not be compressed. Component ids are
+// assigned in order of the roots' ids.
+template <class Seq>
+inline component_index BuildComponentIndex(const Seq &parents) {
+    size_t n = parents.size();
+    component_index index;
+    index.component = sequence<uintE>(n, [&](size_t i) {
+        parent p = parents[i];
+        while (parents[p] != p) {
+            p = parents[p];
+        }
+        return (uintE)p;
+    });
+    index.num_components = contract::RelabelIds(index.component);
+
+    // The integer sort is stable, so members are increasing within each
+    // component.
+    index.members = sequence<uintE>(n, [&](size_t i) { return (uintE)i; });
+    auto get_component = [&](uintE v) -> size_t { return index.component[v]; };
+    pbbs::integer_sort_inplace(index.members.slice(), get_component,
+                               pbbslib::log2_up(index.num_components));
+    auto is_start = pbbs::delayed_seq<bool>(n, [&](size_t i) {
+        return i == 0 || index.component[index.members[i]] !=
+                             index.component[index.members[i - 1]];
+    });
+    auto starts = pbbs::pack_index<uintT>(is_start);
+    index.offsets = sequence<uintT>(index.num_components + 1, [&](size_t c) {
+        return (c == index.num_components) ? (uintT)n : starts[c];
+    });
+    return index;
+}
+
+} // namespace gbbs
@@ -0,0 +1,68 @@
+#include "benchmarks/Connectivity/component_index.h"
+
+#include <cstdio>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "pbbslib/seq.h"
+
+using ::testing::ElementsAre;
+
+namespace gbbs {
+
+namespace {
+
+// Checks that both indices describe the same components with the same ids.
+void ExpectSameIndex(const component_index &expected,
+                     const component_index &actual) {
+    EXPECT_EQ(actual.num_components, expected.num_components);
+    ASSERT_EQ(actual.num_vertices(), expected.num_vertices());
+    for (size_t v = 0; v < expected.num_vertices(); v++) {
+        EXPECT_EQ(actual.component_of(v), expected.component_of(v));
+        EXPECT_EQ(actual.members[v], expected.members[v]);
+    }
+    ASSERT_EQ(actual.offsets.size(), expected.offsets.size());
+    for (size_t c = 0; c < expected.offsets.size(); c++) {
+        EXPECT_EQ(actual.offsets[c], expected.offsets[c]);
+    }
+}
+
+} // namespace
+
+TEST(ComponentIndex, WriteAndRead) {
+    // Parent forest with the components {0, 2, 4}, {1, 3} and {5}. The tree
+    // rooted at 4 is not compressed.
+    const pbbs::sequence<parent> kParents{4, 3, 0, 3, 4, 5};
+    const component_index index{BuildComponentIndex(kParents)};
+    ASSERT_EQ(index.num_components, 3);
+    EXPECT_TRUE(index.connected(0, 2));
+    EXPECT_FALSE(index.connected(0, 1));
+    EXPECT_THAT(index.component_members(index.component_of(2)),
+                ElementsAre(0, 2, 4));
+
+    const std::string index_file{::testing::TempDir() +
+                                 "component_index_test"};
+    ASSERT_TRUE(index.write(index_file));
+    component_index read_index;
+    ASSERT_TRUE(read_index.read(index_file));
+    ExpectSameIndex(index, read_index);
+    std::remove(index_file.c_str());
+}
+
+TEST(ComponentIndex, WriteAndReadEmptyGraph) {
+    const pbbs::sequence<parent> kParents{};
+    const component_index index{BuildComponentIndex(kParents)};
+    EXPECT_EQ(index.num_components, 0);
+    EXPECT_EQ(index.size_histogram().size(), 0);
+
+    const std::string index_file{::testing::TempDir() +
+                                 "component_index_empty_test"};
+    ASSERT_TRUE(index.write(index_file));
+    component_index read_index;
+    ASSERT_TRUE(read_index.read(index_file));
+    ExpectSameIndex(index, read_index);
+    std::remove(index_file.c_str());
+}
+
+} // namespace gbbs
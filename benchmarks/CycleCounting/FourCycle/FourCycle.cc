@@ -0,0 +1,146 @@
+// Usage:
+// numactl -i all ./FourCycle -s -mode vertex -peel -nl 1000000 <graph>
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -rounds : the number of times to run the algorithm
+//     -mode : global, vertex or edge (default global); what to count
+//     -agg : batch, hash or sort (default batch); how wedges are aggregated
+//            (sort is only supported in the global mode)
+//     -peel : also compute the tip (vertex mode) or wing (edge mode)
+//             decomposition
+//     -nl : for the tip decomposition, the number of left vertices of the
+//           bipartite graph; vertices [0, nl) form the left side
+//     -side : left or right (default left); the side whose vertices are
+//             peeled by the tip decomposition
+//     -nb : the number of buckets to use for peeling (default 16)
+//
+// The graph must be uncompressed.
+
+#include "FourCycle.h"
+
+namespace gbbs {
+
+template <class W>
+size_t run_four_cycle(symmetric_graph<symmetric_vertex, W> &G,
+                      const std::string &mode, four_cycle::aggregation agg,
+                      bool peel, size_t num_left, bool left,
+                      size_t num_buckets) {
+    timer t;
+    t.start();
+    size_t count = 0;
+    if (mode == "global") {
+        count = four_cycle::CountFourCycles(G, agg);
+        t.next("count time");
+    } else if (mode == "vertex") {
+        auto counts = four_cycle::VertexFourCycles(G, agg);
+        t.next("count time");
+        count = pbbslib::reduce_add(counts) / 4;
+        std::cout << "### Max vertex count = " << pbbslib::reduce_max(counts)
+                  << std::endl;
+        if (peel) {
+            auto in_side = [&](uintE v) { return (v < num_left) == left; };
+            auto tips = four_cycle::TipDecomposition(G, in_side, agg,
+                                                     num_buckets);
+            t.next("tip decomposition time");
+            std::cout << "### Max tip number = " << pbbslib::reduce_max(tips)
+                      << std::endl;
+        }
+    } else if (mode == "edge") {
+        auto counts = four_cycle::EdgeFourCycles(G, agg);
+        t.next("count time");
+        count = pbbslib::reduce_add(counts) / 8;
+        std::cout << "### Max edge count = " << pbbslib::reduce_max(counts)
+                  << std::endl;
+        if (peel) {
+            auto wings = four_cycle::WingDecomposition(G, agg, num_buckets);
+            t.next("wing decomposition time");
+            std::cout << "### Max wing number = " << pbbslib::reduce_max(wings)
+                      << std::endl;
+        }
+    } else {
+        std::cerr << "Unexpected mode: " << mode << '\n';
+        exit(1);
+    }
+    return count;
+}
+template <class Graph>
+size_t run_four_cycle(Graph &G, const std::string &mode,
+                      four_cycle::aggregation agg, bool peel, size_t num_left,
+                      bool left, size_t num_buckets) {
+    std::cout << "FourCycle requires an uncompressed graph" << std::endl;
+    exit(-1);
+}
+
+// The number of edges of G with both endpoints in [0, num_left) or both in
+// [num_left, n).
+template <class Graph>
+size_t non_crossing_edges(Graph &G, size_t num_left) {
+    using W = typename Graph::weight_type;
+    auto per_vertex = sequence<size_t>(G.n, [&](size_t u) {
+        auto f = [&](const uintE &src, const uintE &ngh, const W &wgh) {
+            return (size_t)((src < num_left) == (ngh < num_left));
+        };
+        auto monoid = pbbs::addm<size_t>();
+        return G.get_vertex(u).out_neighbors().reduce(f, monoid);
+    });
+    return pbbslib::reduce_add(per_vertex);
+}
+
+template <class Graph> double FourCycle_runner(Graph &G, commandLine P) {
+    auto mode = P.getOptionValue("-mode", "global");
+    auto agg = P.getOptionValue("-agg", "batch");
+    bool peel = P.getOption("-peel");
+    size_t num_left = P.getOptionLongValue("-nl", 0);
+    auto side = P.getOptionValue("-side", "left");
+    size_t num_buckets = P.getOptionLongValue("-nb", 16);
+    std::cout << "### Application: FourCycle" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -mode = " << mode << " -agg = " << agg
+              << " -peel = " << peel << " -nl = " << num_left
+              << " -side = " << side << " -nb = " << num_buckets << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+    assert(P.getOption("-s"));
+    if (agg != "batch" && agg != "hash" &&
+        (agg != "sort" || mode != "global")) {
+        std::cout << "-agg must be batch or hash (or sort, in the global mode)"
+                  << std::endl;
+        exit(1);
+    }
+    auto aggregation = (agg == "sort")   ? four_cycle::aggregation::sort
+                       : (agg == "hash") ? four_cycle::aggregation::hash
+                                         : four_cycle::aggregation::batch;
+    if (peel && mode == "vertex") {
+        if (num_left == 0 || num_left >= G.n ||
+            (side != "left" && side != "right")) {
+            std::cout << "the tip decomposition needs -nl between 1 and n - 1"
+                         " and -side left or right"
+                      << std::endl;
+            exit(1);
+        }
+        size_t bad = non_crossing_edges(G, num_left);
+        if (bad > 0) {
+            std::cout << "the graph is not bipartite with -nl = " << num_left
+                      << ": " << bad / 2 << " edges do not cross" << std::endl;
+            exit(1);
+        }
+    }
+
+    timer t;
+    t.start();
+    size_t count = run_four_cycle(G, mode, aggregation, peel, num_left,
+                                  side == "left", num_buckets);
+    double tt = t.stop();
+    std::cout << "### Num 4-cycles = " << count << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_symmetric_main(gbbs::FourCycle_runner, false);
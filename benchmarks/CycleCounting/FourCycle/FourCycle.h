@@ -0,0 +1,704 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "benchmarks/CycleCounting/Kowalik5Cycle/FiveCycle.h"
+#include "gbbs/bucket.h"
+#include "gbbs/edge_ids.h"
+#include "gbbs/gbbs.h"
+#include "pbbslib/integer_sort.h"
+
+// Counting and peeling of 4-cycles; on a bipartite graph these are the
+// butterflies (2x2 bicliques).
+//
+// The kernels work on the input relabeled by decreasing degree (see
+// DegreeOrderedGraph), so that vertex 0 has the largest degree. A 4-cycle is
+// counted from its smallest (i.e. highest-degree) vertex u: every wedge
+// u - v - w with v, w > u is aggregated by its endpoint w, and c wedges with
+// the same endpoints close C(c, 2) cycles (Chiba and Nishizeki; Wang et al.).
+// The relabeling keeps the high-degree endpoints, which are hit by most
+// wedges, at the front of the counter array, and with neighbor lists sorted
+// in increasing order the neighbors above u are a suffix of each list. The
+// public functions take the input graph and return per-vertex and per-edge
+// values indexed by its vertex and edge IDs.
+//
+// Wedges of a start vertex are aggregated by endpoint with one of:
+//   batch: a per-worker array of n counters (O(n * num_workers()) space),
+//   hash: a per-worker hash table sized to the wedges of the start vertex,
+//         so the space is proportional to the largest such set,
+//   sort: for the global count only, writing out all wedges as keys and
+//         sorting them (O(#wedges) space).
+namespace gbbs {
+namespace four_cycle {
+
+enum class aggregation { batch, sort, hash };
+
+// The input relabeled by decreasing degree with orderNodesByDegree, with
+// neighbor lists in increasing order. Vertex i of the result is
+// order_to_vertex[i] in G.
+template <class W>
+inline symmetric_graph<symmetric_vertex, W>
+DegreeOrderedGraph(symmetric_graph<symmetric_vertex, W> &G,
+                   sequence<uintT> &order_to_vertex) {
+    order_to_vertex = orderNodesByDegree(G, G.n);
+    auto GDO = relabel_graph(G, order_to_vertex);
+    // relabel_graph sorts the lists in decreasing order.
+    parallel_for(
+        0, GDO.n,
+        [&](size_t i) {
+            auto nghs = GDO.e0 + GDO.v_data[i].offset;
+            std::reverse(nghs, nghs + GDO.v_data[i].degree);
+        },
+        1);
+    return GDO;
+}
+
+namespace internal {
+// The index of the first neighbor of v above u.
+template <class W>
+inline uintT first_above(const symmetric_graph<symmetric_vertex, W> &G,
+                         uintE v, uintE u) {
+    auto nghs = G.e0 + G.v_data[v].offset;
+    auto end = nghs + G.v_data[v].degree;
+    auto it = std::upper_bound(
+        nghs, end, u, [](uintE a, const std::tuple<uintE, W> &b) {
+            return a < std::get<0>(b);
+        });
+    return it - nghs;
+}
+
+template <class W>
+inline uintE neighbor(const symmetric_graph<symmetric_vertex, W> &G, uintE v,
+                      uintT i) {
+    return std::get<0>(G.e0[G.v_data[v].offset + i]);
+}
+
+inline size_t choose2(size_t c) { return c * (c - (c > 0)) / 2; }
+
+// Per-worker counters indexed by vertex, in an array of size n; zero between
+// uses.
+template <class V> struct dense_space {
+    sequence<V> values;
+    std::vector<uintE> touched;
+    explicit dense_space(size_t n) : values(n, (V)0) {}
+    // Called before up to max_keys distinct keys are added.
+    void prepare(size_t max_keys) {}
+    inline void add(uintE w, V d = 1) {
+        if (values[w] == 0) {
+            touched.push_back(w);
+        }
+        values[w] += d;
+    }
+    inline V get(uintE w) const { return values[w]; }
+    void reset() {
+        for (uintE w : touched) {
+            values[w] = 0;
+        }
+        touched.clear();
+    }
+};
+
+// Per-worker counters indexed by vertex, in an open-addressing table with a
+// power of two of at least twice as many slots as keys; empty between uses.
+// The table only grows to the largest set of keys the worker aggregates.
+template <class V> struct hash_space {
+    using entry = std::pair<uintE, V>;
+    std::vector<entry> table;
+    size_t mask;
+    std::vector<uintE> touched;
+    std::vector<size_t> slots;
+    explicit hash_space(size_t n) : mask(0) {}
+    void prepare(size_t max_keys) {
+        size_t size = (size_t)1 << pbbslib::log2_up(
+                          std::max(2 * max_keys, (size_t)16));
+        if (size > table.size()) {
+            table.assign(size, entry(UINT_E_MAX, (V)0));
+        }
+        mask = size - 1;
+    }
+    inline size_t find(uintE w) const {
+        size_t h = pbbs::hash32(w) & mask;
+        while (table[h].first != w && table[h].first != UINT_E_MAX) {
+            h = (h + 1) & mask;
+        }
+        return h;
+    }
+    inline void add(uintE w, V d = 1) {
+        size_t h = find(w);
+        if (table[h].first == UINT_E_MAX) {
+            table[h].first = w;
+            touched.push_back(w);
+            slots.push_back(h);
+        }
+        table[h].second += d;
+    }
+    inline V get(uintE w) const { return table[find(w)].second; }
+    void reset() {
+        for (size_t h : slots) {
+            table[h] = entry(UINT_E_MAX, (V)0);
+        }
+        touched.clear();
+        slots.clear();
+    }
+};
+
+template <class Space>
+inline std::vector<Space> make_spaces(size_t n) {
+    std::vector<Space> spaces;
+    for (int i = 0; i < num_workers(); i++) {
+        spaces.emplace_back(n);
+    }
+    return spaces;
+}
+
+// Calls f(spaces) with per-worker wedge counters for agg (batch or hash).
+template <class V, class F> inline auto with_spaces(size_t n, aggregation agg,
+                                                     F f) {
+    if (agg == aggregation::hash) {
+        auto spaces = make_spaces<hash_space<V>>(n);
+        return f(spaces);
+    }
+    auto spaces = make_spaces<dense_space<V>>(n);
+    return f(spaces);
+}
+
+// Counts the wedges u - v - w with v, w > u by endpoint, and returns the
+// number of 4-cycles whose smallest vertex is u.
+template <class W, class Space>
+inline size_t aggregate(const symmetric_graph<symmetric_vertex, W> &G,
+                        uintE u, Space &S) {
+    uintE deg_u = G.v_data[u].degree;
+    size_t num_wedges = 0;
+    for (uintT i = first_above(G, u, u); i < deg_u; i++) {
+        uintE v = neighbor(G, u, i);
+        num_wedges += G.v_data[v].degree - first_above(G, v, u);
+    }
+    S.prepare(std::min(num_wedges, (size_t)G.n));
+    for (uintT i = first_above(G, u, u); i < deg_u; i++) {
+        uintE v = neighbor(G, u, i);
+        uintE deg_v = G.v_data[v].degree;
+        for (uintT j = first_above(G, v, u); j < deg_v; j++) {
+            S.add(neighbor(G, v, j));
+        }
+    }
+    size_t total = 0;
+    for (uintE w : S.touched) {
+        total += choose2(S.get(w));
+    }
+    return total;
+}
+
+template <class W>
+inline size_t CountSort(symmetric_graph<symmetric_vertex, W> &GDO) {
+    size_t n = GDO.n;
+    auto offsets = sequence<size_t>(n, [&](size_t u) {
+        size_t ct = 0;
+        uintE deg_u = GDO.v_data[u].degree;
+        for (uintT i = first_above(GDO, u, u); i < deg_u; i++) {
+            uintE v = neighbor(GDO, u, i);
+            ct += GDO.v_data[v].degree - first_above(GDO, v, u);
+        }
+        return ct;
+    });
+    size_t num_wedges = pbbslib::scan_add_inplace(offsets);
+    auto keys = sequence<size_t>(num_wedges);
+    parallel_for(
+        0, n,
+        [&](size_t u) {
+            size_t k = offsets[u];
+            uintE deg_u = GDO.v_data[u].degree;
+            for (uintT i = first_above(GDO, u, u); i < deg_u; i++) {
+                uintE v = neighbor(GDO, u, i);
+                uintE deg_v = GDO.v_data[v].degree;
+                for (uintT j = first_above(GDO, v, u); j < deg_v; j++) {
+                    keys[k++] = u * n + neighbor(GDO, v, j);
+                }
+            }
+        },
+        1);
+    pbbs::integer_sort_inplace(
+        keys.slice(), [](size_t k) { return k; },
+        2 * pbbslib::log2_up(std::max(n, (size_t)2)));
+    auto starts = pbbs::pack_index<size_t>(
+        pbbs::delayed_seq<bool>(num_wedges, [&](size_t i) {
+            return i == 0 || keys[i] != keys[i - 1];
+        }));
+    return pbbslib::reduce_add(
+        pbbs::delayed_seq<size_t>(starts.size(), [&](size_t i) {
+            size_t end = (i + 1 == starts.size()) ? num_wedges : starts[i + 1];
+            return choose2(end - starts[i]);
+        }));
+}
+
+// The number of 4-cycles containing each vertex of GDO. Start vertices and
+// endpoints get C(c, 2) for every endpoint reached by c wedges, and the
+// center of each such wedge gets c - 1.
+template <class W, class Space>
+inline sequence<size_t>
+VertexCounts(symmetric_graph<symmetric_vertex, W> &GDO,
+             std::vector<Space> &spaces) {
+    size_t n = GDO.n;
+    auto counts = sequence<size_t>(n, (size_t)0);
+    parallel_for(
+        0, n,
+        [&](size_t u) {
+            auto &S = spaces[worker_id()];
+            size_t ct = aggregate(GDO, u, S);
+            if (ct > 0) {
+                pbbslib::write_add(&counts[u], ct);
+                for (uintE w : S.touched) {
+                    size_t c = choose2(S.get(w));
+                    if (c > 0) {
+                        pbbslib::write_add(&counts[w], c);
+                    }
+                }
+                uintE deg_u = GDO.v_data[u].degree;
+                for (uintT i = first_above(GDO, u, u); i < deg_u; i++) {
+                    uintE v = neighbor(GDO, u, i);
+                    uintE deg_v = GDO.v_data[v].degree;
+                    size_t center = 0;
+                    for (uintT j = first_above(GDO, v, u); j < deg_v; j++) {
+                        center += S.get(neighbor(GDO, v, j)) - 1;
+                    }
+                    if (center > 0) {
+                        pbbslib::write_add(&counts[v], center);
+                    }
+                }
+            }
+            S.reset();
+        },
+        1);
+    return counts;
+}
+
+// The number of 4-cycles containing each edge of GDO, indexed by edge ID
+// (both copies of an edge hold the same value). The wedge u - v - w adds
+// c - 1 to both of its edges, where c is the number of wedges from u to w.
+template <class W, class Space>
+inline sequence<size_t> EdgeCounts(symmetric_graph<symmetric_vertex, W> &GDO,
+                                   const edge_ids<W> &ids,
+                                   std::vector<Space> &spaces) {
+    size_t n = GDO.n;
+    auto counts = ids.edge_property((size_t)0);
+    parallel_for(
+        0, n,
+        [&](size_t u) {
+            auto &S = spaces[worker_id()];
+            if (aggregate(GDO, u, S) > 0) {
+                uintE deg_u = GDO.v_data[u].degree;
+                for (uintT i = first_above(GDO, u, u); i < deg_u; i++) {
+                    uintE v = neighbor(GDO, u, i);
+                    uintE deg_v = GDO.v_data[v].degree;
+                    size_t uv_count = 0;
+                    for (uintT j = first_above(GDO, v, u); j < deg_v; j++) {
+                        size_t c = S.get(neighbor(GDO, v, j)) - 1;
+                        if (c > 0) {
+                            uv_count += c;
+                            pbbslib::write_add(
+                                &counts[ids.canonical(ids.id(v, j))], c);
+                        }
+                    }
+                    if (uv_count > 0) {
+                        pbbslib::write_add(
+                            &counts[ids.canonical(ids.id(u, i))], uv_count);
+                    }
+                }
+            }
+            S.reset();
+        },
+        1);
+    parallel_for(0, GDO.m, [&](size_t e) {
+        uintT r = ids.reverse(e);
+        if (r < e) {
+            counts[e] = counts[r];
+        }
+    });
+    return counts;
+}
+
+// Values of the vertices of GDO, indexed by the vertices of the input.
+inline sequence<size_t>
+vertices_to_input(const sequence<size_t> &values,
+                  const sequence<uintT> &order_to_vertex) {
+    auto out = sequence<size_t>(values.size());
+    parallel_for(0, values.size(),
+                 [&](size_t i) { out[order_to_vertex[i]] = values[i]; });
+    return out;
+}
+
+// Values of the edges of GDO, indexed by the edge IDs (CSR positions) of the
+// input G. The j-th edge (u, w) of G is found in the (sorted) list of u in
+// GDO by binary search.
+template <class W>
+inline sequence<size_t>
+edges_to_input(symmetric_graph<symmetric_vertex, W> &G,
+               const symmetric_graph<symmetric_vertex, W> &GDO,
+               const sequence<size_t> &values,
+               const sequence<uintT> &order_to_vertex) {
+    size_t n = G.n;
+    auto vertex_to_order = sequence<uintE>(n);
+    parallel_for(0, n,
+                 [&](size_t i) { vertex_to_order[order_to_vertex[i]] = i; });
+    auto out = sequence<size_t>(G.m);
+    parallel_for(
+        0, n,
+        [&](size_t u) {
+            uintE i = vertex_to_order[u];
+            uintT off = G.v_data[u].offset;
+            for (uintE j = 0; j < G.v_data[u].degree; j++) {
+                uintE x = vertex_to_order[std::get<0>(G.e0[off + j])];
+                uintT pos = first_above(GDO, i, x) - 1;
+                out[off + j] = values[GDO.v_data[i].offset + pos];
+            }
+        },
+        1);
+    return out;
+}
+} // namespace internal
+
+// The number of 4-cycles of G.
+template <class W>
+inline size_t CountFourCycles(symmetric_graph<symmetric_vertex, W> &G,
+                              aggregation agg = aggregation::batch) {
+    auto order_to_vertex = sequence<uintT>();
+    auto GDO = DegreeOrderedGraph(G, order_to_vertex);
+    size_t count = 0;
+    if (agg == aggregation::sort) {
+        count = internal::CountSort(GDO);
+    } else {
+        count = internal::with_spaces<uintE>(GDO.n, agg, [&](auto &spaces) {
+            auto per_vertex =
+                sequence<size_t>(GDO.n, [&](size_t u) -> size_t {
+                    auto &S = spaces[worker_id()];
+                    size_t ct = internal::aggregate(GDO, u, S);
+                    S.reset();
+                    return ct;
+                });
+            return pbbslib::reduce_add(per_vertex);
+        });
+    }
+    GDO.del();
+    return count;
+}
+
+// The number of 4-cycles containing each vertex of G (agg is batch or hash).
+template <class W>
+inline sequence<size_t>
+VertexFourCycles(symmetric_graph<symmetric_vertex, W> &G,
+                 aggregation agg = aggregation::batch) {
+    auto order_to_vertex = sequence<uintT>();
+    auto GDO = DegreeOrderedGraph(G, order_to_vertex);
+    auto counts = internal::with_spaces<uintE>(
+        GDO.n, agg,
+        [&](auto &spaces) { return internal::VertexCounts(GDO, spaces); });
+    GDO.del();
+    return internal::vertices_to_input(counts, order_to_vertex);
+}
+
+// The number of 4-cycles containing each edge of G, indexed by edge ID (see
+// edge_ids.h; both copies of an edge hold the same value). agg is batch or
+// hash.
+template <class W>
+inline sequence<size_t>
+EdgeFourCycles(symmetric_graph<symmetric_vertex, W> &G,
+               aggregation agg = aggregation::batch) {
+    auto order_to_vertex = sequence<uintT>();
+    auto GDO = DegreeOrderedGraph(G, order_to_vertex);
+    auto ids = make_edge_ids(GDO);
+    auto counts = internal::with_spaces<uintE>(
+        GDO.n, agg,
+        [&](auto &spaces) { return internal::EdgeCounts(GDO, ids, spaces); });
+    auto out = internal::edges_to_input(G, GDO, counts, order_to_vertex);
+    GDO.del();
+    return out;
+}
+
+// Tip decomposition of one side of a bipartite graph G: peels the vertices
+// for which in_side is true in increasing order of their butterfly count,
+// and returns the count of each of them when it was peeled (the entries of
+// the other side are 0). Every butterfly has exactly two vertices on each
+// side, so peeling u removes C(c, 2) butterflies from every other vertex w
+// of the side reached by c wedges u - v - w, whose centers v are on the
+// other side and are never removed. Vertices peeled in the same round do not
+// update each other. agg is batch or hash.
+template <class W, class Side>
+inline sequence<size_t>
+TipDecomposition(symmetric_graph<symmetric_vertex, W> &G, Side in_side,
+                 aggregation agg = aggregation::batch,
+                 size_t num_buckets = 16) {
+    auto order_to_vertex = sequence<uintT>();
+    auto GDO = DegreeOrderedGraph(G, order_to_vertex);
+    size_t n = GDO.n;
+    auto side = sequence<bool>(
+        n, [&](size_t i) { return (bool)in_side(order_to_vertex[i]); });
+    auto counts = internal::with_spaces<uintE>(
+        n, agg,
+        [&](auto &spaces) { return internal::VertexCounts(GDO, spaces); });
+    size_t n_side = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        n, [&](size_t i) { return (size_t)side[i]; }));
+    auto get_bkt = pbbs::delayed_seq<size_t>(n, [&](size_t i) {
+        return side[i] ? counts[i] : std::numeric_limits<size_t>::max();
+    });
+    auto b = make_buckets<uintE, size_t>(n, get_bkt, increasing, num_buckets);
+    auto alive = sequence<bool>(n, true);
+    auto in_round = sequence<bool>(n, false);
+    auto dec = sequence<size_t>(n, (size_t)0);
+    auto touched = sequence<uintE>(n);
+    size_t num_touched = 0;
+    auto decrement = [&](uintE x, size_t d) {
+        if (pbbs::fetch_and_add(&dec[x], d) == 0) {
+            touched[pbbs::fetch_and_add(&num_touched, (size_t)1)] = x;
+        }
+    };
+
+    size_t finished = 0, rounds = 0;
+    internal::with_spaces<uintE>(n, agg, [&](auto &spaces) {
+        while (finished != n_side) {
+            auto bkt = b.next_bucket();
+            auto &active = bkt.identifiers;
+            size_t k = bkt.id;
+            finished += active.size();
+            rounds++;
+            if (finished == n_side) {
+                break;
+            }
+            parallel_for(0, active.size(),
+                         [&](size_t i) { in_round[active[i]] = true; });
+            num_touched = 0;
+
+            parallel_for(
+                0, active.size(),
+                [&](size_t a) {
+                    uintE u = active[a];
+                    auto &S = spaces[worker_id()];
+                    uintE deg_u = GDO.v_data[u].degree;
+                    size_t num_wedges = 0;
+                    for (uintE i = 0; i < deg_u; i++) {
+                        uintE v = internal::neighbor(GDO, u, i);
+                        num_wedges += GDO.v_data[v].degree;
+                    }
+                    S.prepare(std::min(num_wedges, n));
+                    for (uintE i = 0; i < deg_u; i++) {
+                        uintE v = internal::neighbor(GDO, u, i);
+                        for (uintE j = 0; j < GDO.v_data[v].degree; j++) {
+                            uintE w = internal::neighbor(GDO, v, j);
+                            if (w != u && alive[w] && !in_round[w]) {
+                                S.add(w);
+                            }
+                        }
+                    }
+                    for (uintE w : S.touched) {
+                        size_t c = internal::choose2(S.get(w));
+                        if (c > 0) {
+                            decrement(w, c);
+                        }
+                    }
+                    S.reset();
+                },
+                1);
+
+            auto moved = sequence<std::tuple<uintE, size_t>>(
+                num_touched, [&](size_t i) {
+                    uintE x = touched[i];
+                    size_t current = counts[x];
+                    size_t next =
+                        std::max(current - std::min(current, dec[x]), k);
+                    dec[x] = 0;
+                    counts[x] = next;
+                    return std::make_tuple(x, b.get_bucket(current, next));
+                });
+            auto rebucket = pbbs::filter(
+                moved, [&](const std::tuple<uintE, size_t> &xb) {
+                    return std::get<1>(xb) != b.null_bkt;
+                });
+            b.update_buckets(
+                [&](size_t i) {
+                    return std::optional<std::tuple<uintE, size_t>>(
+                        rebucket[i]);
+                },
+                rebucket.size());
+            parallel_for(0, active.size(), [&](size_t i) {
+                alive[active[i]] = false;
+                in_round[active[i]] = false;
+            });
+        }
+        return 0;
+    });
+    b.del();
+    GDO.del();
+    debug(std::cout << "tip rounds = " << rounds << std::endl;);
+    parallel_for(0, n, [&](size_t i) {
+        if (!side[i]) {
+            counts[i] = 0;
+        }
+    });
+    return internal::vertices_to_input(counts, order_to_vertex);
+}
+
+// Wing decomposition: peels the edges of G in increasing order of their
+// 4-cycle count, and returns the count of each edge (by edge ID of G) when it
+// was peeled. A cycle containing several edges of a round is subtracted
+// once, by the one with the smallest canonical ID. agg is batch or hash.
+template <class W>
+inline sequence<size_t>
+WingDecomposition(symmetric_graph<symmetric_vertex, W> &G,
+                  aggregation agg = aggregation::batch,
+                  size_t num_buckets = 16) {
+    using edge_t = uintT;
+    auto order_to_vertex = sequence<uintT>();
+    auto GDO = DegreeOrderedGraph(G, order_to_vertex);
+    auto ids = make_edge_ids(GDO);
+    size_t n = GDO.n;
+    size_t m = GDO.m;
+    auto counts = internal::with_spaces<uintE>(
+        n, agg,
+        [&](auto &spaces) { return internal::EdgeCounts(GDO, ids, spaces); });
+    auto is_canonical = [&](edge_t e) { return e < ids.reverse(e); };
+    size_t n_edges = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        m, [&](size_t e) { return (size_t)is_canonical(e); }));
+    auto get_bkt = pbbs::delayed_seq<size_t>(m, [&](size_t e) {
+        return is_canonical(e) ? counts[e] : std::numeric_limits<size_t>::max();
+    });
+    auto b = make_buckets<edge_t, size_t>(m, get_bkt, increasing, num_buckets);
+    auto alive = ids.edge_property(true);
+    auto in_round = ids.edge_property(false);
+    auto dec = ids.edge_property((size_t)0);
+    auto touched = sequence<edge_t>(m);
+    size_t num_touched = 0;
+    auto decrement = [&](edge_t e) {
+        if (pbbs::fetch_and_add(&dec[e], (size_t)1) == 0) {
+            touched[pbbs::fetch_and_add(&num_touched, (size_t)1)] = e;
+        }
+    };
+
+    size_t finished = 0;
+    // Per-worker marks: mark.get(t) is 1 + the ID of the edge (x, t).
+    internal::with_spaces<edge_t>(n, agg, [&](auto &marks) {
+        while (finished != n_edges) {
+            auto bkt = b.next_bucket();
+            auto &active = bkt.identifiers;
+            size_t k = bkt.id;
+            finished += active.size();
+            if (finished == n_edges) {
+                break;
+            }
+            parallel_for(0, active.size(),
+                         [&](size_t i) { in_round[active[i]] = true; });
+            num_touched = 0;
+
+            parallel_for(
+                0, active.size(),
+                [&](size_t a) {
+                    edge_t xy = active[a];
+                    uintE x = ids.source(xy), y = ids.target(xy);
+                    // Walk the two-hop neighborhood through the endpoint of
+                    // smaller degree, and mark the neighbors of the other
+                    // one.
+                    if (GDO.v_data[x].degree < GDO.v_data[y].degree) {
+                        std::swap(x, y);
+                    }
+                    uintE deg_x = GDO.v_data[x].degree;
+                    auto &mark = marks[worker_id()];
+                    auto skip = [&](edge_t e) {
+                        return !alive[e] || (in_round[e] && e < xy);
+                    };
+                    auto on_cycle = [&](edge_t yz, edge_t zt, edge_t tx) {
+                        for (edge_t e : {yz, zt, tx}) {
+                            if (!in_round[e]) {
+                                decrement(e);
+                            }
+                        }
+                    };
+                    mark.prepare(deg_x);
+                    uintT off_x = GDO.v_data[x].offset;
+                    for (uintE i = 0; i < deg_x; i++) {
+                        edge_t xt = ids.canonical(off_x + i);
+                        if (xt != xy && !skip(xt)) {
+                            mark.add(ids.target(off_x + i), xt + 1);
+                        }
+                    }
+                    // Cycles x - y - z - t - x. The neighbors t of z are
+                    // scanned, or looked up in N(z) if z has a much larger
+                    // degree than x.
+                    uintT off_y = GDO.v_data[y].offset;
+                    for (uintE i = 0; i < GDO.v_data[y].degree; i++) {
+                        uintE z = ids.target(off_y + i);
+                        edge_t yz = ids.canonical(off_y + i);
+                        if (z == x || skip(yz)) {
+                            continue;
+                        }
+                        uintE deg_z = GDO.v_data[z].degree;
+                        if (deg_z > edge_ids<W>::kSearchRatio * deg_x) {
+                            for (uintE j = 0; j < deg_x; j++) {
+                                uintE t = ids.target(off_x + j);
+                                edge_t tx = mark.get(t);
+                                if (t == y || tx == 0) {
+                                    continue;
+                                }
+                                edge_t zt = ids.find(z, t);
+                                if (zt != ids.kNone &&
+                                    !skip(ids.canonical(zt))) {
+                                    on_cycle(yz, ids.canonical(zt), tx - 1);
+                                }
+                            }
+                            continue;
+                        }
+                        uintT off_z = GDO.v_data[z].offset;
+                        for (uintE j = 0; j < deg_z; j++) {
+                            uintE t = ids.target(off_z + j);
+                            edge_t zt = ids.canonical(off_z + j);
+                            if (t == y || skip(zt)) {
+                                continue;
+                            }
+                            edge_t tx = mark.get(t);
+                            if (tx != 0) {
+                                on_cycle(yz, zt, tx - 1);
+                            }
+                        }
+                    }
+                    mark.reset();
+                },
+                1);
+
+            auto moved = sequence<std::tuple<edge_t, size_t>>(
+                num_touched, [&](size_t i) {
+                    edge_t e = touched[i];
+                    size_t current = counts[e];
+                    size_t next =
+                        std::max(current - std::min(current, dec[e]), k);
+                    dec[e] = 0;
+                    counts[e] = next;
+                    return std::make_tuple(e, b.get_bucket(current, next));
+                });
+            auto rebucket = pbbs::filter(
+                moved, [&](const std::tuple<edge_t, size_t> &eb) {
+                    return std::get<1>(eb) != b.null_bkt;
+                });
+            b.update_buckets(
+                [&](size_t i) {
+                    return std::optional<std::tuple<edge_t, size_t>>(
+                        rebucket[i]);
+                },
+                rebucket.size());
+            parallel_for(0, active.size(), [&](size_t i) {
+                alive[active[i]] = false;
+                in_round[active[i]] = false;
+            });
+        }
+        return 0;
+    });
+    b.del();
+    parallel_for(0, m, [&](size_t e) {
+        uintT r = ids.reverse(e);
+        if (r < e) {
+            counts[e] = counts[r];
+        }
+    });
+    auto out = internal::edges_to_input(G, GDO, counts, order_to_vertex);
+    GDO.del();
+    return out;
+}
+
+} // namespace four_cycle
+} // namespace gbbs
@@ -30,8 +30,11 @@
 //     -c : indicate that the graph should be mmap'd
 //     -m : indicate that the graph is compressed
 //     -lf : use the LF (largest degree first) herustic
+//     -speculative : use optimistic coloring with conflict-resolution rounds
+//     -distance2 : compute a distance-2 coloring (speculatively)
 //     -stats : output statistics on the resulting coloring
-//     -verify : verify that the algorithm produced a valid coloring
+//     -verify : verify that the algorithm produced a valid coloring (of the
+//        requested distance)
 //
 // The default heuristic used is LLF, which provably achieves polynomial
 // parallelism (see "Ordering Heuristics for Parallel Graph Coloring" by
@@ -43,25 +46,43 @@
 #include <iostream>
 
 namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("coloring.txt");
+#endif
+
 template <class Graph> double Coloring_runner(Graph &G, commandLine P) {
     bool runLF = P.getOption("-lf");
+    bool speculative = P.getOption("-speculative");
+    bool distance2 = P.getOption("-distance2");
     std::cout << "### Application: Coloring" << std::endl;
     std::cout << "### Graph: " << P.getArgument(0) << std::endl;
     std::cout << "### Threads: " << num_workers() << std::endl;
     std::cout << "### n: " << G.n << std::endl;
     std::cout << "### m: " << G.m << std::endl;
-    std::cout << "### Params: -lf = " << runLF << std::endl;
+    std::cout << "### Params: -lf = " << runLF
+              << " -speculative = " << speculative
+              << " -distance2 = " << distance2 << std::endl;
     std::cout << "### ------------------------------------" << std::endl;
 
     timer t;
     t.start();
-    auto colors = Coloring(G, runLF);
+    sequence<uintE> colors;
+    if (distance2) {
+        colors = Distance2Coloring(G);
+    } else if (speculative) {
+        colors = SpeculativeColoring(G);
+    } else {
+        colors = Coloring(G, runLF);
+    }
     double tt = t.stop();
+    size_t num_colors = (G.n == 0) ? 0 : pbbslib::reduce_max(colors) + 1;
+    std::cout << "### Colors used: " << num_colors << std::endl;
     if (P.getOption("-stats")) {
         std::cout << "num_colors = " << pbbslib::reduce_max(colors) << "\n";
     }
-    if (P.getOption("-verify)")) {
-        verify_coloring(G, colors);
+    if (P.getOption("-verify")) {
+        verify_coloring(G, colors, distance2);
     }
 
     std::cout << "### Running Time: " << tt << std::endl;
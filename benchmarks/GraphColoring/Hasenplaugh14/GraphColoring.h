@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "gbbs/gbbs.h"
 
 #include "pbbslib/random_shuffle.h"
@@ -168,13 +170,136 @@ inline sequence<uintE> Coloring(Graph &G, bool lf = false) {
     return colors;
 }
 
+namespace coloring {
+// Per-worker scratch space for first-fit over large neighborhoods: mark[c]
+// == stamp iff color c is taken, so the marks never need to be cleared.
+struct color_space {
+    std::vector<size_t> mark;
+    size_t stamp = 0;
+
+    void take(uintE c) {
+        if (c == UINT_E_MAX)
+            return;
+        if (c >= mark.size())
+            mark.resize(2 * (size_t)c + 1, 0);
+        mark[c] = stamp;
+    }
+    uintE first_free() const {
+        uintE c = 0;
+        while (c < mark.size() && mark[c] == stamp)
+            c++;
+        return c;
+    }
+};
+
+// Applies f to every vertex at distance one or two from v, other than v
+// (possibly more than once).
+template <class Graph, class F>
+inline void map_distance2(Graph &G, uintE v, F f) {
+    using W = typename Graph::weight_type;
+    auto inner_f = [&](const uintE &u, const uintE &w, const W &wgh) {
+        if (w != v)
+            f(w);
+    };
+    auto outer_f = [&](const uintE &src, const uintE &u, const W &wgh) {
+        f(u);
+        G.get_vertex(u).out_neighbors().map(inner_f, false);
+    };
+    G.get_vertex(v).out_neighbors().map(outer_f, false);
+}
+
+// The smallest color not used within distance two of v.
+template <class Graph, class Seq>
+inline uintE distance2_color(Graph &G, uintE v, Seq &colors,
+                             color_space &S) {
+    S.stamp++;
+    map_distance2(G, v, [&](uintE u) { S.take(colors[u]); });
+    return S.first_free();
+}
+
+// Speculative coloring: every uncolored vertex takes a color at once, using
+// first_fit(v) and the colors currently visible, and then every vertex that
+// has the same color as a conflicting vertex (as reported by conflicts(v, f),
+// which calls f on the candidates) of higher priority is uncolored again.
+// Conflicts only arise between vertices colored in the same round, and the
+// highest-priority vertex of every conflict keeps its color, so the number
+// of uncolored vertices drops every round.
+template <class Graph, class FirstFit, class Conflicts>
+inline sequence<uintE> Speculative(Graph &G, FirstFit first_fit,
+                                   Conflicts conflicts) {
+    size_t n = G.n;
+    auto colors = sequence<uintE>(n, [](size_t i) { return UINT_E_MAX; });
+    auto P = pbbslib::random_permutation<uintE>(n);
+    auto U = sequence<uintE>(n, [](size_t i) { return (uintE)i; });
+    size_t rounds = 0;
+    while (U.size() > 0) {
+        par_for(0, U.size(), 1,
+                [&](size_t i) { colors[U[i]] = first_fit(U[i], colors); });
+        auto conflicted = pbbs::filter(U, [&](uintE v) {
+            bool lost = false;
+            conflicts(v, [&](uintE u) {
+                lost |= (colors[u] == colors[v] && P[u] < P[v]);
+            });
+            return lost;
+        });
+        U = std::move(conflicted);
+        rounds++;
+    }
+    std::cout << "### Total rounds = " << rounds << "\n";
+    return colors;
+}
+} // namespace coloring
+
+// Optimistic (Gebremedhin-Manne style) coloring: color all vertices greedily
+// in parallel, then recolor the lower-priority endpoint of every conflicting
+// edge, until no conflicts remain. The number of rounds is usually small and
+// does not depend on the length of the dependency chains of Coloring.
+template <class Graph> inline sequence<uintE> SpeculativeColoring(Graph &G) {
+    using W = typename Graph::weight_type;
+    auto first_fit = [&](uintE v, sequence<uintE> &colors) {
+        return coloring::color(G, v, colors);
+    };
+    auto conflicts = [&](uintE v, auto f) {
+        auto map_f = [&](const uintE &src, const uintE &u, const W &wgh) {
+            f(u);
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+    };
+    return coloring::Speculative(G, first_fit, conflicts);
+}
+
+// Distance-2 coloring (vertices within distance two get different colors,
+// e.g. for computing a Jacobian from compressed columns), by the same
+// speculative scheme. The work of a round is the number of paths of length
+// at most two from the vertices being colored.
+template <class Graph> inline sequence<uintE> Distance2Coloring(Graph &G) {
+    auto spaces = std::vector<coloring::color_space>(num_workers());
+    auto first_fit = [&](uintE v, sequence<uintE> &colors) {
+        return coloring::distance2_color(G, v, colors, spaces[worker_id()]);
+    };
+    auto conflicts = [&](uintE v, auto f) {
+        coloring::map_distance2(G, v, f);
+    };
+    return coloring::Speculative(G, first_fit, conflicts);
+}
+
+// Counts the vertices that share their color with a neighbor (or, if
+// distance2 is set, with a vertex within distance two).
 template <class Graph, class Seq>
-inline void verify_coloring(Graph &G, Seq &colors) {
+inline void verify_coloring(Graph &G, Seq &colors, bool distance2 = false) {
     using W = typename Graph::weight_type;
     size_t n = G.n;
     auto ok = sequence<bool>(n);
     par_for(0, n, [&](size_t i) {
         uintE src_color = colors[i];
+        if (distance2) {
+            size_t ct = 0;
+            coloring::map_distance2(G, i, [&](uintE u) {
+                ct += (colors[u] == src_color);
+            });
+            ok[i] = (ct > 0);
+            return;
+        }
         auto pred = [&](const uintE &src, const uintE &ngh, const W &wgh) {
             uintE ngh_color = colors[ngh];
             return src_color == ngh_color;
@@ -0,0 +1,76 @@
+// Usage:
+// numactl -i all ./Partition -k 64 -rounds 3 -s -m com-orkut.ungraph.txt_SJ
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -rounds : the number of times to run the algorithm
+//     -k : the number of parts (default 2)
+//     -eps : the allowed imbalance; parts hold at most (1 + eps) n / k
+//      vertices (default 0.03)
+//     -coarsen : matching (default) or ldd
+//     -beta : the LDD parameter when coarsening with ldd
+//     -coarsest : stop coarsening below this many vertices
+//     -seed : the random seed
+//     -outfile : write the part of every vertex, one per line
+
+#include "Partition.h"
+
+#include <fstream>
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("partition.txt");
+#endif
+
+template <class Graph> double Partition_runner(Graph &G, commandLine P) {
+    partition::params params;
+    params.k = P.getOptionLongValue("-k", 2);
+    params.imbalance = P.getOptionDoubleValue("-eps", 0.03);
+    std::string coarsen = P.getOptionValue("-coarsen", "matching");
+    params.coarsen = (coarsen == "ldd") ? partition::coarsening::ldd
+                                        : partition::coarsening::matching;
+    params.beta = P.getOptionDoubleValue("-beta", 0.5);
+    params.coarsest = P.getOptionLongValue("-coarsest", 0);
+    params.seed = P.getOptionLongValue("-seed", 0);
+    auto outfile = P.getOptionValue("-outfile", "");
+    std::cout << "### Application: Multilevel Partitioning" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -k = " << params.k
+              << " -eps = " << params.imbalance << " -coarsen = " << coarsen
+              << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+    assert(P.getOption("-s"));
+    if (params.k < 1 || params.k > G.n) {
+        std::cout << "k must be in [1, n]" << std::endl;
+        exit(-1);
+    }
+
+    timer t;
+    t.start();
+    auto result = partition::Partition(G, params);
+    double tt = t.stop();
+
+    std::cout << "### Levels: " << result.levels << std::endl;
+    std::cout << "### Edge cut: " << result.cut << " ("
+              << (double)result.cut / (G.m / 2) << " of the edges)"
+              << std::endl;
+    std::cout << "### Balance: " << result.balance << std::endl;
+    if (!outfile.empty()) {
+        std::ofstream out(outfile);
+        for (size_t i = 0; i < G.n; i++)
+            out << result.parts[i] << "\n";
+    }
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_symmetric_main(gbbs::Partition_runner, false);
@@ -0,0 +1,774 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+#include "benchmarks/LowDiameterDecomposition/MPX13/LowDiameterDecomposition.h"
+#include "benchmarks/MaximalMatching/RandomGreedy/MaximalMatching.h"
+#include "gbbs/contract.h"
+#include "gbbs/gbbs.h"
+#include "pbbslib/sample_sort.h"
+
+// Multilevel k-way edge-cut partitioning.
+//
+// Coarsening contracts either a maximal matching (first on the edges of best
+// rating at one of their endpoints, then on any remaining edges between
+// unmatched vertices) or the clusters of a low-diameter decomposition, with
+// the weighted contract::contract summing the weights of parallel edges.
+// Vertex weights count the input vertices a coarse vertex stands for, and
+// no coarse vertex is heavier than a fixed fraction of a part: matchings
+// skip the edges that would exceed it, and LDD clusters that exceed it are
+// split by a matching. Coarsening stops at a few vertices per part or when a
+// level no longer shrinks the graph.
+//
+// The coarsest graph is partitioned by recursive bisection, growing every
+// split from several seeds and keeping the smallest cut. The partition is
+// then projected back level by level and refined at each level, first with
+// balanced label propagation: in every round, a random half of the vertices
+// propose a move to the neighboring part with the largest gain in cut
+// weight, and the proposals into each part are accepted by decreasing gain
+// while the part stays within its weight limit. Label propagation only takes
+// improving moves, so it is followed by a boundary FM pass, which can climb
+// out of local minima through moves of negative gain.
+// Parts that are over the limit are rebalanced first by moving their
+// cheapest vertices to parts with room.
+namespace gbbs {
+namespace partition {
+
+enum class coarsening { matching, ldd };
+
+struct params {
+    size_t k = 2;
+    double imbalance = 0.03; // parts may weigh (1 + imbalance) * n / k
+    coarsening coarsen = coarsening::matching;
+    double beta = 0.5;      // for ldd coarsening
+    size_t coarsest = 0;    // coarsening target; 0 means 16 vertices per part
+    size_t refine_rounds = 16;
+    size_t seed = 0;
+};
+
+struct result {
+    sequence<uintE> parts; // part of every vertex, in [0, k)
+    size_t cut;            // total weight of the edges between parts
+    double balance;        // heaviest part weight / (n / k)
+    size_t levels;
+};
+
+using coarse_graph = symmetric_graph<symmetric_vertex, size_t>;
+
+namespace internal {
+
+template <class W> inline size_t weight_of(const W &w) {
+    if constexpr (std::is_same<W, pbbslib::empty>::value) {
+        return 1;
+    } else {
+        return static_cast<size_t>(w);
+    }
+}
+
+// (part, total edge weight from a vertex to its neighbors in that part),
+// sorted by part. One per worker.
+using part_weights = std::vector<std::pair<uintE, size_t>>;
+
+template <class Graph>
+inline void neighbor_parts(Graph &G, uintE v, const sequence<uintE> &part,
+                           part_weights &out) {
+    using W = typename Graph::weight_type;
+    out.clear();
+    auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+        if (x != v) {
+            out.emplace_back(part[x], weight_of(w));
+        }
+    };
+    G.get_vertex(v).out_neighbors().map(map_f, false);
+    std::sort(out.begin(), out.end(),
+              [](const std::pair<uintE, size_t> &a,
+                 const std::pair<uintE, size_t> &b) {
+                  return a.first < b.first;
+              });
+    size_t k = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+        if (k > 0 && out[k - 1].first == out[i].first) {
+            out[k - 1].second += out[i].second;
+        } else {
+            out[k++] = out[i];
+        }
+    }
+    out.resize(k);
+}
+
+inline bool can_move(uintE v, size_t round, size_t seed) {
+    return pbbs::hash64(pbbs::hash64(seed * 1000003 + round) + v) & 1;
+}
+
+// The rating of an edge for matching: its weight, with ties (all edges on
+// the first level, most of them on the next ones) broken in favor of light
+// endpoints, so that coarse vertices grow evenly instead of around whichever
+// vertices were matched first. (Breaking ties by the product of the degrees
+// instead matches hubs with their degree-one neighbors first, which more than
+// doubled the cut on RMAT graphs.)
+using edge_rating = std::pair<size_t, double>;
+
+inline edge_rating rating(size_t w, size_t weight_u, size_t weight_v) {
+    return {w, 1 / ((double)weight_u * (double)weight_v)};
+}
+
+// Clusters of at most two vertices from maximal matchings of G that only use
+// edges (u, v) with allowed(u, v) whose endpoints weigh at most max_weight
+// together. The first matching only uses edges of locally best rating (the
+// best rating at one of their endpoints), the second one any remaining edge.
+// Matched vertices get the smaller id of the pair.
+template <class Graph, class Allowed>
+inline sequence<uintE> MatchingClusters(Graph &G, const sequence<size_t> &vw,
+                                        size_t max_weight, Allowed allowed) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    auto best = sequence<edge_rating>(n, [&](size_t v) {
+        edge_rating b = {0, 0};
+        auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+            if (allowed(u, x) && vw[u] + vw[x] <= max_weight) {
+                b = std::max(b, rating(weight_of(w), vw[u], vw[x]));
+            }
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+        return b;
+    });
+    auto mate = sequence<uintE>(n, UINT_E_MAX);
+    for (size_t pass = 0; pass < 2; pass++) {
+        auto pred = [&](const uintE &u, const uintE &v, const W &w) {
+            if (mate[u] != UINT_E_MAX || mate[v] != UINT_E_MAX ||
+                vw[u] + vw[v] > max_weight || !allowed(u, v)) {
+                return false;
+            }
+            auto r = rating(weight_of(w), vw[u], vw[v]);
+            return pass == 1 || r == best[u] || r == best[v];
+        };
+        auto GM = filterGraph(G, pred);
+        if (GM.m > 0) {
+            auto matching = MaximalMatching(GM);
+            parallel_for(0, matching.size(), [&](size_t i) {
+                uintE u = std::get<0>(matching[i]) & mm::VAL_MASK;
+                uintE v = std::get<1>(matching[i]) & mm::VAL_MASK;
+                mate[u] = v;
+                mate[v] = u;
+            });
+        }
+        GM.del();
+    }
+    return sequence<uintE>(n, [&](size_t v) {
+        return (mate[v] == UINT_E_MAX) ? (uintE)v
+                                       : std::min((uintE)v, mate[v]);
+    });
+}
+
+// The clusters of a low-diameter decomposition of G, except that clusters
+// heavier than max_weight are broken up into the clusters of a matching on
+// their inner edges. Every cluster is labeled by one of its vertices.
+template <class Graph>
+inline sequence<uintE> LDDClusters(Graph &G, const sequence<size_t> &vw,
+                                   size_t max_weight, double beta) {
+    size_t n = G.n;
+    auto clusters = LDD(G, beta, /* permute = */ true);
+    auto cluster_weight = contract::cluster_sums<size_t>(clusters, n, vw);
+    auto heavy = [&](uintE v) {
+        return cluster_weight[clusters[v]] > max_weight;
+    };
+    auto split = MatchingClusters(G, vw, max_weight,
+                                  [&](const uintE &u, const uintE &v) {
+                                      return heavy(u) && heavy(v) &&
+                                             clusters[u] == clusters[v];
+                                  });
+    parallel_for(0, n, [&](size_t v) {
+        if (heavy(v)) {
+            clusters[v] = split[v];
+        }
+    });
+    return clusters;
+}
+
+// Grows a region inside `vertices` (the vertices with part == first; index[v]
+// is the position of v in `vertices`) from `source` until it weighs about
+// `target`, jumping to the next vertex outside the region when the region has
+// no more neighbors. With greedy, it is greedy graph growing: the next vertex
+// is the one whose addition shrinks the cut the most, and isolated vertices,
+// which do not change the cut, come before any vertex that grows it.
+// Otherwise vertices are added in BFS order. Marks the region in in_region
+// and returns the weight of the edges between the region and the rest of
+// `vertices`.
+template <class Graph>
+inline size_t GrowRegion(Graph &G, const sequence<size_t> &vw,
+                         const std::vector<uintE> &vertices,
+                         const std::vector<intT> &inner_degree,
+                         const sequence<uintE> &part, uintE first,
+                         const sequence<uintE> &index, size_t source,
+                         size_t target, bool greedy,
+                         std::vector<bool> &in_region) {
+    using W = typename Graph::weight_type;
+    size_t size = vertices.size();
+    in_region.assign(size, false);
+    // gain(i) = (weight to the region) - (weight to the rest)
+    std::vector<intT> to_region(size, 0);
+    auto gain = [&](size_t i) { return 2 * to_region[i] - inner_degree[i]; };
+    // Keys are gains, or minus the discovery time in BFS order.
+    std::priority_queue<std::pair<intT, uintE>> heap;
+    intT discovered = 0;
+    heap.emplace(greedy ? gain(source) : 0, source);
+    for (size_t i = 0; i < size && greedy; i++) {
+        if (inner_degree[i] == 0 && i != source)
+            heap.emplace(0, i);
+    }
+    size_t weight = 0, next = 0;
+    intT cut = 0;
+    while (true) {
+        size_t i;
+        if (heap.empty()) {
+            while (next < size && in_region[next])
+                next++;
+            if (next == size)
+                break;
+            i = next;
+        } else {
+            auto [g, j] = heap.top();
+            heap.pop();
+            if (in_region[j] || (greedy && g != gain(j)))
+                continue;
+            i = j;
+        }
+        uintE v = vertices[i];
+        if (weight > 0 && weight + vw[v] / 2 >= target)
+            break;
+        in_region[i] = true;
+        weight += vw[v];
+        cut -= gain(i);
+        auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+            if (x != v && part[x] == first && !in_region[index[x]]) {
+                uintE j = index[x];
+                bool found = (to_region[j] == 0);
+                to_region[j] += weight_of(w);
+                if (greedy) {
+                    heap.emplace(gain(j), j);
+                } else if (found) {
+                    heap.emplace(--discovered, j);
+                }
+            }
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+    }
+    return cut;
+}
+
+// Recursive bisection of the coarsest graph: the vertices of `vertices`
+// (all with part[v] == first) are split into k parts first, ..., first + k - 1
+// by growing a region of weight fraction floor(k / 2) / k with GrowRegion, and
+// both sides are split recursively. The region with the smallest cut is kept
+// among greedy growing from several seeds (a pseudo-peripheral vertex, the
+// last vertex reached by a BFS, and random vertices) and the BFS order from
+// the pseudo-peripheral vertex, which does better on graphs with hubs.
+// Sequential; only used on the coarsest graph.
+template <class Graph>
+inline void Bisect(Graph &G, const sequence<size_t> &vw,
+                   std::vector<uintE> vertices, uintE first, size_t k,
+                   sequence<uintE> &part, sequence<uintE> &mark,
+                   sequence<uintE> &index, uintE &rounds, size_t seed) {
+    using W = typename Graph::weight_type;
+    if (k == 1 || vertices.empty()) {
+        return;
+    }
+    size_t size = vertices.size();
+    for (size_t i = 0; i < size; i++)
+        index[vertices[i]] = i;
+    auto inner_degree = std::vector<intT>(size, 0);
+    for (size_t i = 0; i < size; i++) {
+        uintE v = vertices[i];
+        auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+            if (x != v && part[x] == first)
+                inner_degree[i] += weight_of(w);
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+    }
+    // BFS from `source` restricted to the vertices with part == first; mark[v]
+    // records the last BFS that visited v. Returns the last vertex reached.
+    auto bfs = [&](uintE source) {
+        uintE round = rounds++;
+        std::vector<uintE> queue = {source};
+        mark[source] = round;
+        for (size_t head = 0; head < queue.size(); head++) {
+            auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+                if (part[x] == first && mark[x] != round) {
+                    mark[x] = round;
+                    queue.push_back(x);
+                }
+            };
+            G.get_vertex(queue[head]).out_neighbors().map(map_f, false);
+        }
+        return queue.back();
+    };
+    uintE peripheral = bfs(bfs(vertices[0]));
+
+    size_t k1 = k / 2;
+    size_t total = 0;
+    for (uintE v : vertices)
+        total += vw[v];
+    size_t target = (total * k1) / k;
+    constexpr size_t kSeeds = 8;
+    std::vector<bool> region, best_region;
+    size_t best_cut = std::numeric_limits<size_t>::max();
+    for (size_t s = 0; s <= std::min(kSeeds, size); s++) {
+        size_t start =
+            (s <= 1) ? index[peripheral]
+                     : pbbs::hash64(pbbs::hash64(seed + first) + s) % size;
+        size_t cut = GrowRegion(G, vw, vertices, inner_degree, part, first,
+                                index, start, target, s > 0, region);
+        if (cut < best_cut) {
+            best_cut = cut;
+            std::swap(region, best_region);
+        }
+    }
+    std::vector<uintE> left, right;
+    for (size_t i = 0; i < size; i++) {
+        if (best_region[i]) {
+            left.push_back(vertices[i]);
+        } else {
+            right.push_back(vertices[i]);
+            part[vertices[i]] = first + k1;
+        }
+    }
+    vertices.clear();
+    Bisect(G, vw, std::move(left), first, k1, part, mark, index, rounds, seed);
+    Bisect(G, vw, std::move(right), first + k1, k - k1, part, mark, index,
+           rounds, seed);
+}
+
+template <class Graph>
+inline sequence<uintE> InitialPartition(Graph &G, const sequence<size_t> &vw,
+                                        size_t k, size_t seed) {
+    size_t n = G.n;
+    auto part = sequence<uintE>(n, (uintE)0);
+    auto mark = sequence<uintE>(n, UINT_E_MAX);
+    auto index = sequence<uintE>(n);
+    std::vector<uintE> vertices(n);
+    for (size_t v = 0; v < n; v++)
+        vertices[v] = v;
+    uintE rounds = 0;
+    Bisect(G, vw, std::move(vertices), 0, k, part, mark, index, rounds, seed);
+    return part;
+}
+
+// A proposed move of a vertex to part `to`, with the change in cut weight
+// (positive if the cut shrinks) and the weight of the vertex.
+struct proposal {
+    uintE v;
+    uintE to;
+    intT gain;
+    size_t weight;
+};
+
+// Accepts, for every target part, the moves into it by decreasing gain while
+// the part stays within max_weight, counting the weight of the accepted moves
+// out of the part as room, and applies them. Since rejecting a move frees
+// less room in its source part, the accepted set is recomputed until it no
+// longer shrinks (or, after a few tries, without counting departures), so the
+// result always respects max_weight. Returns the number of accepted moves.
+inline size_t apply_moves(sequence<proposal> &moves, sequence<uintE> &part,
+                          const sequence<size_t> &part_weight, size_t k,
+                          size_t max_weight) {
+    size_t num = moves.size();
+    if (num == 0)
+        return 0;
+    auto sorted =
+        pbbs::sample_sort(moves, [](const proposal &a, const proposal &b) {
+            return a.to < b.to || (a.to == b.to && a.gain > b.gain);
+        });
+    auto arriving = sequence<size_t>(
+        num, [&](size_t i) { return sorted[i].weight; });
+    pbbslib::scan_add_inplace(arriving.slice(), pbbs::fl_scan_inclusive);
+    auto is_start = pbbs::delayed_seq<bool>(num, [&](size_t i) {
+        return i == 0 || sorted[i].to != sorted[i - 1].to;
+    });
+    auto starts = pbbs::pack_index<size_t>(is_start);
+    auto from =
+        sequence<uintE>(num, [&](size_t i) { return part[sorted[i].v]; });
+
+    auto accept = sequence<bool>(num, true);
+    constexpr size_t kTries = 8;
+    for (size_t t = 0; t <= kTries; t++) {
+        auto leaving = sequence<size_t>(k, (size_t)0);
+        if (t < kTries) {
+            auto weights = pbbs::delayed_seq<size_t>(num, [&](size_t i) {
+                return accept[i] ? sorted[i].weight : 0;
+            });
+            leaving = contract::cluster_sums<size_t>(from, k, weights);
+        }
+        auto next = sequence<bool>(num, false);
+        parallel_for(0, starts.size(), [&](size_t g) {
+            size_t start = starts[g];
+            size_t end = (g + 1 == starts.size()) ? num : starts[g + 1];
+            size_t before = (start == 0) ? 0 : arriving[start - 1];
+            uintE to = sorted[start].to;
+            size_t limit = max_weight + leaving[to];
+            parallel_for(start, end, [&](size_t i) {
+                next[i] = part_weight[to] + (arriving[i] - before) <= limit;
+            });
+        });
+        bool same = true;
+        for (size_t i = 0; i < num && same; i++) {
+            same = (next[i] == accept[i]);
+        }
+        accept = std::move(next);
+        if (same)
+            break;
+    }
+    auto accepted = pbbs::pack(sorted, accept);
+    parallel_for(0, accepted.size(),
+                 [&](size_t i) { part[accepted[i].v] = accepted[i].to; });
+    return accepted.size();
+}
+
+// Moves vertices out of the parts heavier than max_weight, cheapest (in cut
+// weight) first, to the neighboring part with room that they are most
+// connected to, or else to a random part with room.
+template <class Graph>
+inline void Rebalance(Graph &G, const sequence<size_t> &vw,
+                      sequence<uintE> &part, size_t k, size_t max_weight) {
+    size_t n = G.n;
+    auto spaces = std::vector<part_weights>(num_workers());
+    for (size_t iter = 0; iter < 32; iter++) {
+        auto part_weight = contract::cluster_sums<size_t>(part, k, vw);
+        auto over = pbbs::delayed_seq<bool>(
+            k, [&](size_t p) { return part_weight[p] > max_weight; });
+        if (pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+                k, [&](size_t p) { return (size_t)over[p]; })) == 0) {
+            return;
+        }
+        auto has_room = pbbs::delayed_seq<bool>(
+            k, [&](size_t p) { return part_weight[p] < max_weight; });
+        auto light = pbbs::pack_index<uintE>(has_room);
+        if (light.size() == 0) {
+            return;
+        }
+        auto candidates = sequence<proposal>(n);
+        auto is_candidate = sequence<bool>(n, false);
+        parallel_for(
+            0, n,
+            [&](size_t v) {
+                uintE own = part[v];
+                if (!over[own])
+                    return;
+                auto &nw = spaces[worker_id()];
+                neighbor_parts(G, v, part, nw);
+                size_t own_conn = 0, best_conn = 0;
+                uintE best = light[pbbs::hash64(v + iter) % light.size()];
+                for (auto &[p, w] : nw) {
+                    if (p == own) {
+                        own_conn = w;
+                    } else if (part_weight[p] + vw[v] <= max_weight &&
+                               w > best_conn) {
+                        best_conn = w;
+                        best = p;
+                    }
+                }
+                if (best == own)
+                    return;
+                candidates[v] = proposal{(uintE)v, best,
+                                     (intT)best_conn - (intT)own_conn, vw[v]};
+                is_candidate[v] = true;
+            },
+            1);
+        auto cand = pbbs::pack(candidates, is_candidate);
+        // Group by source part, cheapest first, and take a prefix of each
+        // group that removes the excess weight.
+        auto sorted = pbbs::sample_sort(cand, [&](const proposal &a,
+                                                  const proposal &b) {
+            uintE pa = part[a.v], pb = part[b.v];
+            return pa < pb || (pa == pb && a.gain > b.gain);
+        });
+        size_t num = sorted.size();
+        auto moved = sequence<size_t>(
+            num, [&](size_t i) { return sorted[i].weight; });
+        pbbslib::scan_add_inplace(moved.slice(), pbbs::fl_scan_inclusive);
+        auto is_start = pbbs::delayed_seq<bool>(num, [&](size_t i) {
+            return i == 0 || part[sorted[i].v] != part[sorted[i - 1].v];
+        });
+        auto starts = pbbs::pack_index<size_t>(is_start);
+        auto take = sequence<bool>(num, false);
+        parallel_for(0, starts.size(), [&](size_t g) {
+            size_t start = starts[g];
+            size_t end = (g + 1 == starts.size()) ? num : starts[g + 1];
+            size_t before = (start == 0) ? 0 : moved[start - 1];
+            uintE from = part[sorted[start].v];
+            size_t excess = part_weight[from] - max_weight;
+            parallel_for(start, end, [&](size_t i) {
+                take[i] = moved[i] - sorted[i].weight - before < excess;
+            });
+        });
+        auto taken = pbbs::pack(sorted, take);
+        if (apply_moves(taken, part, part_weight, k, max_weight) == 0) {
+            return;
+        }
+    }
+}
+
+// The best move of v to a neighboring part that can take it without
+// exceeding max_weight, as (gain, part); the part is part[v] if there is none.
+template <class Graph>
+inline std::pair<intT, uintE> best_move(Graph &G, const sequence<size_t> &vw,
+                                        const sequence<uintE> &part,
+                                        const std::vector<size_t> &part_weight,
+                                        size_t max_weight, uintE v,
+                                        part_weights &nw) {
+    neighbor_parts(G, v, part, nw);
+    uintE own = part[v];
+    size_t own_conn = 0, best_conn = 0;
+    uintE best = own;
+    for (auto &[p, w] : nw) {
+        if (p == own) {
+            own_conn = w;
+        } else if ((best == own || w > best_conn) &&
+                   part_weight[p] + vw[v] <= max_weight) {
+            best_conn = w;
+            best = p;
+        }
+    }
+    return {(intT)best_conn - (intT)own_conn, best};
+}
+
+// Sequential k-way FM on the boundary: repeatedly moves the vertex with the
+// largest gain, which may be negative, to the neighboring part it is most
+// connected to among those with room, moving every vertex at most once per
+// pass, and then rolls the pass back to the smallest cut it reached. A pass
+// gives up after kFruitless moves without a new smallest cut, and passes are
+// repeated while they improve the cut.
+//
+// Gains are kept lazily: a move only raises the keys of the neighbors by a
+// bound on how much their gain can grow (the weight of their edge to the
+// moved vertex, twice that for the neighbors it left behind), and the gain of
+// a vertex is only recomputed when its key reaches the top of the heap, so
+// that high-degree neighbors are not rescanned after every move.
+template <class Graph>
+inline void BoundaryFM(Graph &G, const sequence<size_t> &vw,
+                       sequence<uintE> &part, size_t k, size_t max_weight) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    constexpr size_t kPasses = 4;
+    constexpr size_t kFruitless = 128;
+    auto spaces = std::vector<part_weights>(num_workers());
+    auto moved = sequence<bool>(n, false);
+    auto key = sequence<intT>(n);
+    for (size_t pass = 0; pass < kPasses; pass++) {
+        auto weights = contract::cluster_sums<size_t>(part, k, vw);
+        std::vector<size_t> part_weight(weights.begin(), weights.end());
+        // The key of an inner vertex is minus its degree, its gain once a
+        // neighbor leaves for another part.
+        auto is_boundary = sequence<bool>(n);
+        parallel_for(0, n, [&](size_t v) {
+            bool boundary = false;
+            size_t degree = 0;
+            auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+                boundary |= (part[x] != part[v]);
+                degree += (x != v) ? weight_of(w) : 0;
+            };
+            G.get_vertex(v).out_neighbors().map(map_f, false);
+            is_boundary[v] = boundary;
+            key[v] = boundary ? best_move(G, vw, part, part_weight,
+                                          max_weight, v, spaces[worker_id()])
+                                    .first
+                              : -(intT)degree;
+        });
+        auto boundary = pbbs::pack_index<uintE>(is_boundary);
+        using entry = std::pair<intT, uintE>;
+        auto initial = sequence<entry>(boundary.size(), [&](size_t i) {
+            return entry(key[boundary[i]], boundary[i]);
+        });
+        std::priority_queue<entry> heap(initial.begin(), initial.end());
+        auto &nw = spaces[0];
+
+        std::vector<std::pair<uintE, uintE>> log; // (vertex, old part)
+        intT change = 0, best_change = 0;
+        size_t best_length = 0;
+        while (!heap.empty() && log.size() - best_length < kFruitless) {
+            auto [g, v] = heap.top();
+            heap.pop();
+            if (moved[v] || g != key[v])
+                continue;
+            auto [gain, to] =
+                best_move(G, vw, part, part_weight, max_weight, v, nw);
+            if (to == part[v])
+                continue;
+            if (gain < g) {
+                key[v] = gain;
+                heap.emplace(gain, v);
+                continue;
+            }
+            uintE from = part[v];
+            part_weight[from] -= vw[v];
+            part_weight[to] += vw[v];
+            part[v] = to;
+            moved[v] = true;
+            log.emplace_back(v, from);
+            change += gain;
+            if (change > best_change) {
+                best_change = change;
+                best_length = log.size();
+            }
+            auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+                if (moved[x] || part[x] == to)
+                    return;
+                intT w_x = weight_of(w);
+                key[x] += (part[x] == from) ? 2 * w_x : w_x;
+                heap.emplace(key[x], x);
+            };
+            G.get_vertex(v).out_neighbors().map(map_f, false);
+        }
+        for (size_t i = log.size(); i > best_length; i--) {
+            part[log[i - 1].first] = log[i - 1].second;
+        }
+        for (auto &[v, from] : log)
+            moved[v] = false;
+        if (best_change == 0)
+            break;
+    }
+}
+
+// Balanced label propagation followed by BoundaryFM (see the top of the
+// file).
+template <class Graph>
+inline void Refine(Graph &G, const sequence<size_t> &vw, sequence<uintE> &part,
+                   size_t k, size_t max_weight, const params &P,
+                   size_t level) {
+    size_t n = G.n;
+    Rebalance(G, vw, part, k, max_weight);
+    auto spaces = std::vector<part_weights>(num_workers());
+    auto proposals = sequence<proposal>(n);
+    auto proposed = sequence<bool>(n);
+    size_t seed = pbbs::hash64(P.seed + level);
+    size_t idle = 0;
+    for (size_t round = 0; round < P.refine_rounds && idle < 2; round++) {
+        auto part_weight = contract::cluster_sums<size_t>(part, k, vw);
+        parallel_for(
+            0, n,
+            [&](size_t v) {
+                proposed[v] = false;
+                if (!can_move(v, round, seed))
+                    return;
+                uintE own = part[v];
+                auto &nw = spaces[worker_id()];
+                neighbor_parts(G, v, part, nw);
+                size_t own_conn = 0, best_conn = 0;
+                uintE best = own;
+                for (auto &[p, w] : nw) {
+                    if (p == own) {
+                        own_conn = w;
+                    } else if (w > best_conn) {
+                        best_conn = w;
+                        best = p;
+                    }
+                }
+                if (best != own && best_conn > own_conn) {
+                    proposals[v] = proposal{(uintE)v, best,
+                                        (intT)(best_conn - own_conn), vw[v]};
+                    proposed[v] = true;
+                }
+            },
+            1);
+        auto moves = pbbs::pack(proposals, proposed);
+        size_t accepted = apply_moves(moves, part, part_weight, k, max_weight);
+        idle = (accepted == 0) ? idle + 1 : 0;
+    }
+    BoundaryFM(G, vw, part, k, max_weight);
+}
+
+// One coarsening step: returns the clusters (ids in [0, num_clusters)) of the
+// vertices of G.
+template <class Graph>
+inline sequence<uintE> Coarsen(Graph &G, const sequence<size_t> &vw,
+                               size_t max_weight, const params &P,
+                               size_t &num_clusters) {
+    auto any = [](const uintE &u, const uintE &v) { return true; };
+    auto clusters = (P.coarsen == coarsening::ldd)
+                        ? LDDClusters(G, vw, max_weight, P.beta)
+                        : MatchingClusters(G, vw, max_weight, any);
+    num_clusters = contract::RelabelIds(clusters);
+    return clusters;
+}
+
+template <class Graph>
+inline size_t CutWeight(Graph &G, const sequence<uintE> &part) {
+    using W = typename Graph::weight_type;
+    auto cut = pbbs::delayed_seq<size_t>(G.n, [&](size_t v) {
+        size_t c = 0;
+        auto map_f = [&](const uintE &u, const uintE &x, const W &w) {
+            if (part[x] != part[v])
+                c += weight_of(w);
+        };
+        G.get_vertex(v).out_neighbors().map(map_f, false);
+        return c;
+    });
+    return pbbslib::reduce_add(cut) / 2;
+}
+
+// Partitions G (level `level` of the hierarchy, with vertex weights vw) by
+// coarsening it, partitioning the coarser graph recursively, and projecting
+// and refining the result.
+template <class Graph>
+inline sequence<uintE> Multilevel(Graph &G, const sequence<size_t> &vw,
+                                  size_t total, const params &P, size_t level,
+                                  size_t &levels) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    size_t k = P.k;
+    size_t coarsest = (P.coarsest > 0) ? P.coarsest : 16 * k;
+    size_t max_part = (size_t)std::ceil((1 + P.imbalance) * total / k);
+    levels = std::max(levels, level + 1);
+
+    sequence<uintE> part;
+    size_t num_clusters = n;
+    sequence<uintE> clusters;
+    if (n > coarsest) {
+        // A coarse vertex is at most a third of the weight target per part.
+        size_t max_vertex = std::max((size_t)1, total / (3 * k));
+        clusters = Coarsen(G, vw, max_vertex, P, num_clusters);
+    }
+    if (n <= coarsest || num_clusters > 0.95 * n) {
+        part = InitialPartition(G, vw, k, P.seed);
+    } else {
+        auto weight = [&](const W &w) { return weight_of(w); };
+        auto GC = contract::contract(G, clusters, num_clusters, weight,
+                                     pbbs::addm<size_t>())
+                      .first;
+        auto coarse_vw =
+            contract::cluster_sums<size_t>(clusters, num_clusters, vw);
+        auto coarse_part =
+            Multilevel(GC, coarse_vw, total, P, level + 1, levels);
+        GC.del();
+        part = sequence<uintE>(
+            n, [&](size_t v) { return coarse_part[clusters[v]]; });
+    }
+    Refine(G, vw, part, k, max_part, P, level);
+    return part;
+}
+
+} // namespace internal
+
+// Partitions the vertices of the symmetric graph G into P.k parts of at most
+// (1 + P.imbalance) * n / k vertices (when the vertex weights allow it),
+// minimizing the total weight of the edges between parts. Unweighted graphs
+// have unit edge weights.
+template <class Graph>
+inline result Partition(Graph &G, const params &P = params()) {
+    size_t n = G.n;
+    auto vw = sequence<size_t>(n, (size_t)1);
+    size_t levels = 0;
+    auto parts = internal::Multilevel(G, vw, n, P, 0, levels);
+    size_t cut = internal::CutWeight(G, parts);
+    auto part_weight = contract::cluster_sums<size_t>(parts, P.k, vw);
+    double heaviest = pbbslib::reduce_max(part_weight);
+    return result{std::move(parts), cut, heaviest / ((double)n / P.k),
+                  levels};
+}
+
+} // namespace partition
+} // namespace gbbs
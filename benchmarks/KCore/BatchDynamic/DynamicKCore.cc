@@ -0,0 +1,77 @@
+// Usage:
+// numactl -i all ./DynamicKCore -s -update_pct 0.1 -batch_size 10000 <graph>
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -rounds : the number of times to run the benchmark
+//     -update_pct : the fraction of the edges used as updates (default 0.1).
+//                   The starting graph is the input without them; they are
+//                   then inserted in batches and deleted again in batches.
+//     -batch_size : the number of edges in a batch (default 10000)
+//     -verify : after each phase, compare the maintained core numbers with
+//               the coreness of the final graph computed from scratch
+
+#include "DynamicKCore.h"
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("dynamic_kcore.txt");
+#endif
+
+namespace {
+void verify(dynamic_kcore::DynamicKCore &D) {
+    dynamic_batch::verify_values(D.StaticCoreness(), D.core);
+}
+} // namespace
+
+template <class Graph> double DynamicKCore_runner(Graph &G, commandLine P) {
+    double update_pct = P.getOptionDoubleValue("-update_pct", 0.1);
+    size_t batch_size = P.getOptionLongValue("-batch_size", 10000);
+    bool check = P.getOption("-verify");
+    std::cout << "### Application: DynamicKCore" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -update_pct = " << update_pct
+              << " -batch_size = " << batch_size << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+    assert(P.getOption("-s"));
+
+    auto is_update = dynamic_batch::update_sampler(update_pct);
+    auto updates = dynamic_batch::sample_updates(G, is_update);
+    std::cout << "### Updates: " << updates.size() << std::endl;
+
+    timer t;
+    t.start();
+    dynamic_kcore::DynamicKCore D(
+        G, [&](const uintE &u, const uintE &v) { return !is_update(u, v); });
+    std::cout << "### Initialization Time: " << t.get_next() << std::endl;
+
+    auto insert_times = dynamic_batch::run_phase(D, updates, batch_size, true);
+    double tt = t.stop();
+    if (check) {
+        verify(D);
+    }
+    t.start();
+    auto delete_times = dynamic_batch::run_phase(D, updates, batch_size, false);
+    tt += t.stop();
+
+    if (insert_times.size() > 0) {
+        dynamic_batch::report_phase("insert", insert_times, updates.size());
+        dynamic_batch::report_phase("delete", delete_times, updates.size());
+    }
+    std::cout << "### Running Time: " << tt << std::endl;
+    if (check) {
+        verify(D);
+    }
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_symmetric_main(gbbs::DynamicKCore_runner, false);
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "gbbs/bucket.h"
+#include "gbbs/dynamic_batch.h"
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+namespace dynamic_kcore {
+
+using edge = dynamic_batch::edge;
+
+// Exact core numbers of an undirected graph under batches of edge insertions
+// and deletions. Only the core numbers of vertices that can be affected by a
+// batch are recomputed:
+//
+// * Deletions only lower core numbers, so the current values are upper
+//   bounds. They are lowered by iterating the local h-index (as in
+//   KCore_HIndex) from the endpoints of the deleted edges; this converges to
+//   the largest fixed point below the old values, which is the new coreness.
+//
+// * Insertions are applied in rounds. The root of an inserted edge is its
+//   endpoint with the smaller core number (both, on a tie). If every vertex
+//   is the root of at most one edge of a round, inserting the round raises
+//   every core number by at most one (Wang et al.), and a vertex w with core
+//   k can only be raised if it is connected to the root of an inserted edge
+//   through vertices with core k that each have more than k neighbors of
+//   core >= k (the "subcore" traversal of Sariyuce et al.). Those vertices
+//   are found by a parallel traversal from the roots, raised by one, and
+//   lowered again by the h-index iteration. A batch needs at least as many
+//   rounds as the largest number of inserted edges a vertex is the root of.
+//
+// The graph is kept as sorted adjacency vectors.
+struct DynamicKCore : dynamic_batch::adjacency_graph {
+    sequence<uintE> core;
+
+    // Scratch space; flags are false and best entries are max between
+    // operations.
+    sequence<uintE> prev;
+    sequence<bool> flags;
+    sequence<size_t> best;
+
+    // Starts from the subgraph of G containing the edges (u, v) for which
+    // keep(u, v) is true; keep must be symmetric.
+    template <class Graph, class Keep>
+    DynamicKCore(Graph &G, Keep keep)
+        : dynamic_batch::adjacency_graph(G, keep) {
+        prev = sequence<uintE>(n, (uintE)0);
+        flags = sequence<bool>(n, false);
+        best = sequence<size_t>(n, std::numeric_limits<size_t>::max());
+        core = StaticCoreness();
+    }
+
+    // Coreness of the current graph from scratch, by bucketed peeling (as
+    // in KCore_FA).
+    sequence<uintE> StaticCoreness(size_t num_buckets = 16) const {
+        auto D = sequence<uintE>(n, [&](size_t u) { return adj[u].size(); });
+        auto ER = sequence<uintE>(n, (uintE)0);
+        auto b = make_vertex_buckets(n, D, increasing, num_buckets);
+        size_t finished = 0;
+        while (finished != n) {
+            auto bkt = b.next_bucket();
+            uintE k = bkt.id;
+            auto &active = bkt.identifiers;
+            finished += active.size();
+            auto offsets = sequence<size_t>(
+                active.size(), [&](size_t i) { return adj[active[i]].size(); });
+            size_t total = pbbslib::scan_add_inplace(offsets);
+            auto touched = sequence<uintE>(total);
+            parallel_for(0, active.size(), [&](size_t i) {
+                uintE u = active[i];
+                for (size_t j = 0; j < adj[u].size(); j++) {
+                    uintE v = adj[u][j];
+                    bool first = D[v] > k &&
+                                 pbbs::fetch_and_add(&ER[v], (uintE)1) == 0;
+                    touched[offsets[i] + j] = first ? v : UINT_E_MAX;
+                }
+            });
+            auto moved =
+                pbbs::filter(touched, [](uintE v) { return v != UINT_E_MAX; });
+            auto get_bkt = [&](size_t i)
+                -> std::optional<std::tuple<uintE, uintE>> {
+                uintE v = moved[i];
+                uintE deg = D[v];
+                uintE new_deg = std::max(deg - ER[v], k);
+                ER[v] = 0;
+                D[v] = new_deg;
+                return wrap(v, b.get_bucket(deg, new_deg));
+            };
+            b.update_buckets(get_bkt, moved.size());
+        }
+        b.del();
+        return D;
+    }
+
+    // u is a root of the edge (u, v) if its core number is not larger than
+    // v's. Only roots (and vertices reachable from them) can rise.
+    inline bool is_root(uintE u, uintE v) const { return core[u] <= core[v]; }
+
+    void InsertEdges(const sequence<edge> &batch) {
+        auto E = normalize(batch, false);
+        size_t round = 0;
+        while (E.size() > 0) {
+            // Edges whose (random) priority is the smallest at each of their
+            // roots are inserted together.
+            auto priority = [&](size_t i) {
+                return ((size_t)pbbs::hash32(round + i) << 32) | i;
+            };
+            parallel_for(0, E.size(), [&](size_t i) {
+                size_t p = priority(i);
+                uintE u = E[i].first, v = E[i].second;
+                if (is_root(u, v)) {
+                    pbbs::write_min(&best[u], p, std::less<size_t>());
+                }
+                if (is_root(v, u)) {
+                    pbbs::write_min(&best[v], p, std::less<size_t>());
+                }
+            });
+            auto selected = sequence<bool>(E.size(), [&](size_t i) {
+                size_t p = priority(i);
+                uintE u = E[i].first, v = E[i].second;
+                return (!is_root(u, v) || best[u] == p) &&
+                       (!is_root(v, u) || best[v] == p);
+            });
+            parallel_for(0, E.size(), [&](size_t i) {
+                best[E[i].first] = std::numeric_limits<size_t>::max();
+                best[E[i].second] = std::numeric_limits<size_t>::max();
+            });
+            round++;
+            auto M = pbbs::pack(E, selected);
+            insert_round(M);
+            auto rest = pbbs::pack(
+                E, pbbs::delayed_seq<bool>(
+                       E.size(), [&](size_t i) { return !selected[i]; }));
+            E = std::move(rest);
+        }
+    }
+
+    void DeleteEdges(const sequence<edge> &batch) {
+        auto E = normalize(batch, true);
+        if (E.size() == 0) {
+            return;
+        }
+        auto endpoints = remove_edges(dynamic_batch::directed(E));
+        lower_to_fixpoint(std::move(endpoints));
+    }
+
+  private:
+    void insert_round(const sequence<edge> &M) {
+        add_edges(dynamic_batch::directed(M));
+
+        // Subcore traversal from the roots (core numbers are still those from
+        // before the round).
+        auto can_rise = [&](uintE w) {
+            uintE k = core[w];
+            size_t ct = 0;
+            for (uintE x : adj[w]) {
+                ct += (core[x] >= k);
+            }
+            return ct > k;
+        };
+        // Vertices are claimed (flagged) once per round, and only the claimed
+        // ones that can rise are traversed further.
+        auto roots = sequence<uintE>(2 * M.size(), [&](size_t i) {
+            uintE u = (i & 1) ? M[i / 2].second : M[i / 2].first;
+            uintE v = (i & 1) ? M[i / 2].first : M[i / 2].second;
+            return is_root(u, v) ? u : UINT_E_MAX;
+        });
+        auto claimed = pbbs::filter(roots, [&](uintE w) {
+            return w != UINT_E_MAX &&
+                   pbbslib::atomic_compare_and_swap(&flags[w], false, true);
+        });
+        std::vector<sequence<uintE>> visited;
+        std::vector<sequence<uintE>> all_claimed;
+        while (claimed.size() > 0) {
+            auto frontier = pbbs::filter(claimed, can_rise);
+            all_claimed.push_back(std::move(claimed));
+            auto degrees = sequence<size_t>(frontier.size(), [&](size_t i) {
+                return adj[frontier[i]].size();
+            });
+            size_t total = pbbslib::scan_add_inplace(degrees);
+            auto next = sequence<uintE>(total);
+            parallel_for(0, frontier.size(), [&](size_t i) {
+                uintE a = frontier[i];
+                size_t o = degrees[i];
+                for (size_t j = 0; j < adj[a].size(); j++) {
+                    uintE b = adj[a][j];
+                    bool take = core[b] == core[a] && !flags[b] &&
+                                pbbslib::atomic_compare_and_swap(&flags[b],
+                                                                 false, true);
+                    next[o + j] = take ? b : UINT_E_MAX;
+                }
+            });
+            visited.push_back(std::move(frontier));
+            claimed =
+                pbbs::filter(next, [](uintE b) { return b != UINT_E_MAX; });
+        }
+        for (auto &C : all_claimed) {
+            parallel_for(0, C.size(), [&](size_t i) { flags[C[i]] = false; });
+        }
+
+        // Every visited vertex rises by at most one; lower them back to the
+        // largest fixed point.
+        auto sizes = sequence<size_t>(visited.size(), [&](size_t i) {
+            return visited[i].size();
+        });
+        size_t num_visited = pbbslib::scan_add_inplace(sizes);
+        auto S = sequence<uintE>(num_visited);
+        parallel_for(0, visited.size(), [&](size_t i) {
+            parallel_for(0, visited[i].size(), [&](size_t j) {
+                uintE w = visited[i][j];
+                core[w]++;
+                S[sizes[i] + j] = w;
+            });
+        });
+        lower_to_fixpoint(std::move(S));
+    }
+
+    // The h-index of w's neighbors' core values, capped at c = core[w].
+    inline uintE h_index(uintE w, uintE c) const {
+        constexpr uintE kStackCounts = 256;
+        auto &A = adj[w];
+        size_t at_least_c = 0;
+        for (uintE x : A) {
+            at_least_c += (core[x] >= c);
+        }
+        if (at_least_c >= c) {
+            return c;
+        }
+        uintE stack_counts[kStackCounts];
+        std::vector<uintE> heap_counts;
+        uintE *counts = stack_counts;
+        if (c > kStackCounts) {
+            heap_counts.resize(c);
+            counts = heap_counts.data();
+        }
+        std::fill(counts, counts + c, 0);
+        for (uintE x : A) {
+            if (core[x] < c) {
+                counts[core[x]]++;
+            }
+        }
+        size_t total = at_least_c;
+        for (uintE h = c - 1; h > 0; h--) {
+            total += counts[h];
+            if (total >= h) {
+                return h;
+            }
+        }
+        return 0;
+    }
+
+    // Iterates the local h-index, starting from the given vertices, until no
+    // value changes. The current values must be upper bounds on the coreness.
+    void lower_to_fixpoint(sequence<uintE> frontier) {
+        frontier = pbbs::filter(frontier, [&](uintE w) {
+            return pbbslib::atomic_compare_and_swap(&flags[w], false, true);
+        });
+        while (frontier.size() > 0) {
+            auto changed_flags = sequence<bool>(frontier.size(), [&](size_t i) {
+                uintE w = frontier[i];
+                flags[w] = false;
+                uintE c = core[w];
+                uintE h = h_index(w, c);
+                prev[w] = c;
+                core[w] = h;
+                return h < c;
+            });
+            auto changed = pbbs::pack(frontier, changed_flags);
+            auto degrees = sequence<size_t>(changed.size(), [&](size_t i) {
+                return adj[changed[i]].size();
+            });
+            size_t total = pbbslib::scan_add_inplace(degrees);
+            auto next = sequence<uintE>(total);
+            parallel_for(0, changed.size(), [&](size_t i) {
+                uintE s = changed[i];
+                size_t o = degrees[i];
+                for (size_t j = 0; j < adj[s].size(); j++) {
+                    uintE d = adj[s][j];
+                    bool take = core[s] < core[d] && core[d] <= prev[s] &&
+                                !flags[d] &&
+                                pbbslib::atomic_compare_and_swap(&flags[d],
+                                                                 false, true);
+                    next[o + j] = take ? d : UINT_E_MAX;
+                }
+            });
+            frontier =
+                pbbs::filter(next, [](uintE d) { return d != UINT_E_MAX; });
+        }
+    }
+};
+
+} // namespace dynamic_kcore
+} // namespace gbbs
@@ -32,6 +32,11 @@
 //     -rounds : the number of times to run the algorithm
 //     -fa : run the fetch-and-add implementation of k-core
 //     -nb : the number of buckets to use in the bucketing implementation
+//     -hindex : compute coreness by iterated local h-index instead of peeling
+//     -sync : with -hindex, read only the previous iteration's estimates
+//     -iters : with -hindex, stop after this many iterations (the result is
+//              then an upper bound on the coreness); 0 runs to convergence
+//     -verify : compare the result with the coreness computed by KCore
 
 #include "KCore.h"
 
@@ -39,6 +44,10 @@ namespace gbbs {
 template <class Graph> double KCore_runner(Graph &G, commandLine P) {
     size_t num_buckets = P.getOptionLongValue("-nb", 16);
     bool fa = P.getOption("-fa");
+    bool hindex = P.getOption("-hindex");
+    bool sync = P.getOption("-sync");
+    size_t max_iters = P.getOptionLongValue("-iters", 0);
+    bool verify = P.getOption("-verify");
     std::string stat_file = P.getOptionValue("-statFile", "");
     std::cout << "### Application: KCore" << std::endl;
     std::cout << "### Graph: " << P.getArgument(0) << std::endl;
@@ -46,7 +55,9 @@ template <class Graph> double KCore_runner(Graph &G, commandLine P) {
     std::cout << "### n: " << G.n << std::endl;
     std::cout << "### m: " << G.m << std::endl;
     std::cout << "### Params: -nb (num_buckets) = " << num_buckets
-              << " -fa (use fetch_and_add) = " << fa << std::endl;
+              << " -fa (use fetch_and_add) = " << fa
+              << " -hindex = " << hindex << " -sync = " << sync
+              << " -iters = " << max_iters << std::endl;
     std::cout << "### ------------------------------------" << std::endl;
     if (num_buckets !=
         static_cast<size_t>((1 << pbbslib::log2_up(num_buckets)))) {
@@ -62,10 +73,15 @@ template <class Graph> double KCore_runner(Graph &G, commandLine P) {
 #ifdef ACCESS_OBSERVER
     access_observer.set_timer(&t);
 #endif
-    auto cores = (fa) ? KCore_FA(G, num_buckets) : KCore(G, num_buckets);
+    auto cores = (hindex) ? KCore_HIndex(G, !sync, max_iters)
+                 : (fa)   ? KCore_FA(G, num_buckets)
+                          : KCore(G, num_buckets);
     double tt = t.stop();
 
     std::cout << "### Running Time: " << tt << std::endl;
+    if (verify) {
+        VerifyCoreness(G, cores);
+    }
     if (stat_file != "") {
         std::cout << "### Stat file: " << stat_file << std::endl;
         std::cout << "### Saving time to: " << stat_file << std::endl;
@@ -263,6 +263,171 @@ inline sequence<uintE> KCore_FA(Graph &G, size_t num_buckets = 16) {
     return D;
 }
 
+// The h-index of the neighbors' estimates in core, capped at c = core[v]:
+// the largest h <= c such that at least h neighbors have an estimate >= h.
+template <class Graph>
+inline uintE neighbor_h_index(Graph &G, uintE v, uintE c, const uintE *core) {
+    using W = typename Graph::weight_type;
+    constexpr uintE kStackCounts = 256;
+    if (c == 0) {
+        return 0;
+    }
+    auto nghs = G.get_vertex(v).out_neighbors();
+    auto at_least_f = [&](const uintE &u, const uintE &ngh, const W &w) {
+        return core[ngh] >= c;
+    };
+    size_t at_least_c = nghs.count(at_least_f);
+    if (at_least_c >= c) {
+        return c;
+    }
+    // Histogram of the estimates below c.
+    uintE stack_counts[kStackCounts];
+    sequence<uintE> heap_counts;
+    uintE *counts = stack_counts;
+    if (c > kStackCounts) {
+        heap_counts = sequence<uintE>(c);
+        counts = heap_counts.begin();
+    }
+    for (uintE i = 0; i < c; i++) {
+        counts[i] = 0;
+    }
+    auto count_f = [&](const uintE &u, const uintE &ngh, const W &w) {
+        uintE x = core[ngh];
+        if (x < c) {
+            counts[x]++;
+        }
+    };
+    nghs.map(count_f, false);
+    size_t total = at_least_c;
+    for (uintE h = c - 1; h > 0; h--) {
+        total += counts[h];
+        if (total >= h) {
+            return h;
+        }
+    }
+    return 0;
+}
+
+// Emits the neighbors d of a vertex s whose estimate lowered from prev[s] to
+// core[s] in this iteration, when the change can affect d's h-index (core[s]
+// < core[d] <= prev[s]).
+template <class W> struct hindex_notify_f {
+    uintE *core;
+    uintE *prev;
+    bool *in_frontier;
+    hindex_notify_f(uintE *_core, uintE *_prev, bool *_in_frontier)
+        : core(_core), prev(_prev), in_frontier(_in_frontier) {}
+    inline bool affected(const uintE &s, const uintE &d) const {
+        return core[s] < core[d] && core[d] <= prev[s];
+    }
+    inline bool update(const uintE &s, const uintE &d, const W &w) {
+        if (affected(s, d)) {
+            in_frontier[d] = true;
+            return true;
+        }
+        return false;
+    }
+    inline bool updateAtomic(const uintE &s, const uintE &d, const W &w) {
+        return affected(s, d) &&
+               pbbslib::atomic_compare_and_swap(&in_frontier[d], false, true);
+    }
+    inline bool cond(const uintE &d) const { return !in_frontier[d]; }
+};
+
+// Coreness by iterated local h-index (Lu et al.; Sariyuce et al.): every
+// estimate starts at the degree and is repeatedly replaced by the h-index of
+// the neighbors' estimates, which converges to the coreness from above. Only
+// the frontier, i.e. the vertices with a neighbor whose estimate dropped in
+// the previous iteration, is re-evaluated. Unlike KCore, the number of
+// iterations does not grow with the number of distinct core values, and
+// most vertices settle after a few iterations.
+//
+// With async set, new estimates are written in place and read by the rest of
+// the iteration (as in Sariyuce et al.'s AND), which usually converges in
+// fewer iterations; otherwise every iteration reads the previous one's
+// estimates. With max_iters > 0 the computation stops after max_iters
+// iterations, and every returned value is an upper bound on the coreness.
+template <class Graph>
+inline sequence<uintE> KCore_HIndex(Graph &G, bool async = true,
+                                    size_t max_iters = 0) {
+    using W = typename Graph::weight_type;
+    const size_t n = G.n;
+    auto core = sequence<uintE>(
+        n, [&](size_t i) { return G.get_vertex(i).out_degree(); });
+    auto prev = sequence<uintE>(n, [&](size_t i) { return core[i]; });
+    auto next = async ? sequence<uintE>() : sequence<uintE>(n);
+    auto in_frontier = sequence<bool>(n, false);
+    uintE *read = core.begin();
+    uintE *write = async ? core.begin() : next.begin();
+
+    auto Frontier =
+        vertexSubset(n, sequence<uintE>(n, [](size_t i) { return i; }));
+    size_t iters = 0, evaluated = 0;
+    while (!Frontier.isEmpty() && (max_iters == 0 || iters < max_iters)) {
+        Frontier.toSparse();
+        size_t fs = Frontier.size();
+        evaluated += fs;
+        auto changed_flags = sequence<bool>(fs, [&](size_t i) {
+            uintE v = Frontier.vtx(i);
+            in_frontier[v] = false;
+            uintE c = read[v];
+            uintE h = neighbor_h_index(G, v, c, read);
+            prev[v] = c;
+            write[v] = h;
+            return h < c;
+        });
+        auto changed_seq = pbbs::pack(
+            pbbs::delayed_seq<uintE>(fs, [&](size_t i) {
+                return Frontier.vtx(i);
+            }),
+            changed_flags);
+        if (!async) {
+            parallel_for(0, changed_seq.size(), [&](size_t i) {
+                core[changed_seq[i]] = next[changed_seq[i]];
+            });
+        }
+        auto changed = vertexSubset(n, std::move(changed_seq));
+        auto output = edgeMap(
+            G, changed,
+            hindex_notify_f<W>(core.begin(), prev.begin(),
+                               in_frontier.begin()),
+            -1, sparse_blocked);
+        // The changed vertices are final for this iteration.
+        vertexMap(changed, [&](const uintE &v) { prev[v] = core[v]; });
+        changed.del();
+        Frontier.del();
+        Frontier = output;
+        iters++;
+        debug(std::cout << "iter = " << iters << " frontier = " << fs
+                        << std::endl;);
+    }
+    bool converged = Frontier.isEmpty();
+    Frontier.del();
+    uintE k_max = pbbslib::reduce_max(core);
+    std::cout << "### rho = " << iters << " k_{max} = " << k_max << "\n";
+    std::cout << "### evaluations = " << evaluated
+              << " converged = " << converged << "\n";
+    return core;
+}
+
+// Compares cores with the coreness computed by KCore, printing the number of
+// vertices whose values differ and the largest difference. Returns the number
+// of differing vertices.
+template <class Graph>
+inline size_t VerifyCoreness(Graph &G, const sequence<uintE> &cores) {
+    auto exact = KCore(G);
+    auto diff = sequence<size_t>(G.n, [&](size_t i) {
+        return (size_t)((cores[i] > exact[i]) ? cores[i] - exact[i]
+                                              : exact[i] - cores[i]);
+    });
+    size_t mismatches = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        G.n, [&](size_t i) { return (size_t)(diff[i] != 0); }));
+    std::cout << "### Verification: mismatches = " << mismatches
+              << " max difference = " << pbbslib::reduce_max(diff)
+              << std::endl;
+    return mismatches;
+}
+
 template <class Graph>
 inline pbbslib::dyn_arr<uintE> DegeneracyOrder(Graph &G,
                                                size_t num_buckets = 16) {
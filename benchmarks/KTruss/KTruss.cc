@@ -30,21 +30,39 @@
 //     -no_buckets : run an implementation that does not use bucketing
 //                   (using bucketing is default)
 //     -nb : the number of buckets to use in the bucketing implementation
+//     -edge_ids : store trussness in flat arrays indexed by edge ID instead
+//                 of hash tables (uncompressed graphs only)
 
 #include "KTruss.h"
 
 namespace gbbs {
 
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("ktruss.txt");
+#endif
+
+template <class W>
+void run_edge_ids(symmetric_graph<symmetric_vertex, W> &G,
+                  size_t num_buckets) {
+    KTruss_edge_ids(G, num_buckets);
+}
+template <class Graph> void run_edge_ids(Graph &G, size_t num_buckets) {
+    std::cout << "-edge_ids requires an uncompressed graph" << std::endl;
+    exit(-1);
+}
+
 template <class Graph> double KTruss_runner(Graph &G, commandLine P) {
     size_t num_buckets = P.getOptionLongValue("-nb", 16);
     bool no_buckets = P.getOption("-no_buckets");
+    bool use_edge_ids = P.getOption("-edge_ids");
     std::cout << "### Application: KTruss" << std::endl;
     std::cout << "### Graph: " << P.getArgument(0) << std::endl;
     std::cout << "### Threads: " << num_workers() << std::endl;
     std::cout << "### n: " << G.n << std::endl;
     std::cout << "### m: " << G.m << std::endl;
     std::cout << "### Params: -nb (num_buckets) = " << num_buckets
-              << " -no_buckets = " << no_buckets << std::endl;
+              << " -no_buckets = " << no_buckets
+              << " -edge_ids = " << use_edge_ids << std::endl;
     std::cout << "### ------------------------------------" << std::endl;
     if (num_buckets !=
         static_cast<size_t>((1 << pbbslib::log2_up(num_buckets)))) {
@@ -59,7 +77,11 @@ template <class Graph> double KTruss_runner(Graph &G, commandLine P) {
     t.start();
     // auto trusses = (!no_buckets) ? KTruss(G, num_buckets) :
     // KTruss_no_bucket(G);
-    KTruss_ht(G, num_buckets);
+    if (use_edge_ids) {
+        run_edge_ids(G, num_buckets);
+    } else {
+        KTruss_ht(G, num_buckets);
+    }
     double tt = t.stop();
 
     std::cout << "### Running Time: " << tt << std::endl;
@@ -24,6 +24,7 @@
 
 #include "gbbs/bridge.h"
 #include "gbbs/bucket.h"
+#include "gbbs/edge_ids.h"
 #include "gbbs/edge_map_reduce.h"
 #include "gbbs/gbbs.h"
 #include "gbbs/pbbslib/dyn_arr.h"
@@ -371,4 +372,157 @@ template <class Graph> void KTruss_ht(Graph &GA, size_t num_buckets = 16) {
     std::cout << "iters = " << iter << std::endl;
 }
 
+// KTruss_ht with the hash tables replaced by flat arrays indexed by edge ID
+// (see gbbs/edge_ids.h). The trussness of an undirected edge is stored at its
+// canonical ID, and the IDs of the other two edges of a triangle come out of
+// the merge of the endpoints' neighbor lists, so peeling does no hash probes.
+// Decrements are accumulated in a second flat array; the first decrement of
+// an edge in a round appends its ID to the round's list of touched edges.
+//
+// The graph is never packed (packing would invalidate the IDs), and edges
+// peeled in earlier rounds are skipped by their trussness as in KTruss_ht.
+//
+// Returns, for every canonical edge ID, the k of the bucket the edge was
+// peeled from (the number of triangles containing it in the largest truss it
+// belongs to); other IDs hold UINT_E_MAX.
+template <class W>
+sequence<uintE> KTruss_edge_ids(symmetric_graph<symmetric_vertex, W> &GA,
+                                size_t num_buckets = 16) {
+    using edge_t = uintT;
+    using bucket_t = uintE;
+    using trussness_t = uintE;
+
+    timer it;
+    it.start();
+    auto ids = make_edge_ids(GA);
+    auto trussness = ids.template edge_property<trussness_t>(UINT_E_MAX);
+    parallel_for(0, GA.m, [&](size_t e) {
+        if (e < ids.reverse(e)) {
+            trussness[e] = 0;
+        }
+    });
+    size_t n_edges = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        GA.m, [&](size_t e) { return (size_t)(trussness[e] == 0); }));
+
+    // Initially stores #triangles incident/edge.
+    auto rank = truss_utils::rankNodes(GA);
+    auto pack_predicate = [&](const uintE &u, const uintE &v, const W &wgh) {
+        return rank[u] < rank[v];
+    };
+    auto DG = filterGraph(GA, pack_predicate);
+    auto inc_truss_f = [&](const uintE &u, const uintE &v, const uintE &w) {
+        pbbs::fetch_and_add(&trussness[ids.canonical(ids.find(u, v))], 1);
+        pbbs::fetch_and_add(&trussness[ids.canonical(ids.find(u, w))], 1);
+        pbbs::fetch_and_add(&trussness[ids.canonical(ids.find(v, w))], 1);
+    };
+    truss_utils::TCDirected(DG, inc_truss_f);
+    DG.del();
+    it.stop();
+    it.reportTotal("initialization time");
+
+    auto get_bkt = pbbslib::make_sequence<uintE>(
+        GA.m, [&](size_t e) { return trussness[e]; });
+    auto b = make_buckets<edge_t, bucket_t>(GA.m, get_bkt, increasing,
+                                            num_buckets);
+
+    auto peeled = ids.template edge_property<uintE>(UINT_E_MAX);
+    auto decrements = ids.template edge_property<uintE>(0);
+    auto touched = sequence<edge_t>();
+    size_t num_touched = 0;
+    auto decrement_f = [&](edge_t e) {
+        if (pbbs::fetch_and_add(&decrements[e], (uintE)1) == 0) {
+            touched[pbbs::fetch_and_add(&num_touched, (size_t)1)] = e;
+        }
+    };
+
+    timer decrement_t, bt, peeling_t;
+    peeling_t.start();
+    size_t finished = 0, k_max = 0;
+    size_t iter = 0;
+    while (finished != n_edges) {
+        bt.start();
+        auto bkt = b.next_bucket();
+        bt.stop();
+        auto rem_edges = bkt.identifiers;
+        if (rem_edges.size() == 0) {
+            continue;
+        }
+
+        uintE k = bkt.id;
+        finished += rem_edges.size();
+        k_max = std::max(k_max, bkt.id);
+        debug(std::cout << "k = " << k << " iter = " << iter
+                        << " #edges = " << rem_edges.size() << std::endl;);
+        par_for(0, rem_edges.size(),
+                [&](size_t i) { peeled[rem_edges[i]] = k; });
+
+        if (k == 0 || finished == n_edges) {
+            continue;
+        }
+
+        // Each removed edge is in at most k live triangles, each of which
+        // decrements at most two other edges.
+        size_t e_size = 2 * k * rem_edges.size();
+        if (touched.size() < e_size) {
+            touched = sequence<edge_t>(e_size);
+        }
+        num_touched = 0;
+
+        decrement_t.start();
+        par_for(0, rem_edges.size(), 1, [&](size_t i) {
+            edge_t uv = rem_edges[i];
+            auto f = [&](uintE w, edge_t uw, edge_t vw) {
+                uw = ids.canonical(uw);
+                vw = ids.canonical(vw);
+                trussness_t t_uw = trussness[uw];
+                trussness_t t_vw = trussness[vw];
+                if (truss_utils::should_remove(k, (trussness_t)k, t_uw, t_vw,
+                                               uv, uw, vw)) {
+                    if (t_uw > k) {
+                        decrement_f(uw);
+                    }
+                    if (t_vw > k) {
+                        decrement_f(vw);
+                    }
+                }
+            };
+            ids.intersect(ids.source(uv), ids.target(uv), f);
+        });
+        decrement_t.stop();
+
+        auto moved = sequence<std::tuple<edge_t, bucket_t>>(
+            num_touched, [&](size_t i) {
+                edge_t e = touched[i];
+                uintE current = trussness[e];
+                assert(current > k);
+                uintE new_t = std::max(current - decrements[e], k);
+                decrements[e] = 0;
+                trussness[e] = new_t;
+                return std::make_tuple(e, b.get_bucket(current, new_t));
+            });
+        auto rebucket_edges =
+            pbbs::filter(moved, [&](const std::tuple<edge_t, bucket_t> &eb) {
+                return std::get<1>(eb) != UINT_E_MAX;
+            });
+        auto edges_moved_f = [&](size_t i) {
+            return std::optional<std::tuple<edge_t, bucket_t>>(
+                rebucket_edges[i]);
+        };
+        bt.start();
+        b.update_buckets(edges_moved_f, rebucket_edges.size());
+        bt.stop();
+
+        // Mark edges removed in this round.
+        par_for(0, rem_edges.size(),
+                [&](size_t i) { trussness[rem_edges[i]] -= 1; });
+        iter++;
+    }
+    peeling_t.stop();
+    peeling_t.reportTotal("peeling time");
+    bt.reportTotal("Bucketing time");
+    decrement_t.reportTotal("Decrement trussness time");
+    std::cout << "iters = " << iter << " k_max = " << k_max << std::endl;
+    return peeled;
+}
+
 } // namespace gbbs
@@ -0,0 +1,88 @@
+// Usage:
+// numactl -i all ./WeightedMatching -s -w -of matching.txt twitter_wgh_SJ
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//     -w : indicates that the graph is weighted
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -of : write the matching to this file
+//     -if : read a matching written with -of and verify it on the graph
+//     -check : verify the matching on the graph
+//     -rounds : the number of times to run the algorithm
+
+#include "WeightedMatching.h"
+
+#include "gbbs/gbbs.h"
+#include "pbbslib/strings/string_basics.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("weighted_matching.txt");
+#endif
+
+template <template <class W> class vertex, class W>
+double WeightedMatching_runner(symmetric_graph<vertex, W> &G, commandLine P) {
+    std::cout << "### Application: WeightedMatching (Locally Dominant)"
+              << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: (n/a)" << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+
+    assert(P.getOption("-s")); // input graph must be symmetric
+    using edge = weighted_mm::edge<W>;
+    auto in_f = P.getOptionValue("-if");
+    if (in_f) {
+        auto S = gbbs_io::readStringFromFile(in_f);
+        auto Words =
+            pbbs::tokenize(S, [](const char c) { return pbbs::is_space(c); });
+        size_t ms = atol(Words[0]);
+        auto matching = sequence<edge>(ms);
+        par_for(0, ms, pbbslib::kSequentialForThreshold, [&](size_t i) {
+            matching[i] = std::make_tuple(atol(Words[1 + 3 * i]),
+                                          atol(Words[2 + 3 * i]),
+                                          (W)atof(Words[3 + 3 * i]));
+        });
+        verify_weighted_matching(G, matching);
+        exit(0);
+    }
+    timer t;
+    t.start();
+    auto matching = WeightedMatching(G);
+    double tt = t.stop();
+
+    auto weights = pbbs::delayed_seq<double>(
+        matching.size(), [&](size_t i) { return std::get<2>(matching[i]); });
+    std::cout << "### Matching size: " << matching.size() << std::endl;
+    std::cout << "### Matching weight: " << pbbslib::reduce_add(weights)
+              << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+
+    auto of = P.getOptionValue("-of");
+    if (of) {
+        std::ofstream out(of, std::ofstream::out);
+        out << matching.size() << "\n";
+        for (size_t i = 0; i < matching.size(); i++) {
+            auto e = matching[i];
+            out << std::get<0>(e) << " " << std::get<1>(e) << " "
+                << std::get<2>(e) << "\n";
+        }
+        out.close();
+    }
+    if (P.getOptionValue("-check")) {
+        verify_weighted_matching(G, matching);
+    }
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_symmetric_weighted_main(gbbs::WeightedMatching_runner, false);
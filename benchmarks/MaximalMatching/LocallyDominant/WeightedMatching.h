@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "benchmarks/MaximalMatching/RandomGreedy/MaximalMatching.h"
+#include "gbbs/gbbs.h"
+
+#include "pbbslib/random.h"
+
+// A 1/2-approximate maximum weight matching: the greedy matching that scans
+// the edges by decreasing weight. Edges are ordered by weight, then by a hash
+// of their endpoints, then by the endpoints, a strict total order, so the
+// greedy matching is also the unique locally dominant matching (every matched
+// edge is the heaviest edge at both of its endpoints once heavier matched
+// edges are removed).
+//
+// It is computed with the parallel suitor algorithm (Manne and Halappanavar).
+// Every vertex proposes to the neighbor with the heaviest edge whose current
+// suitor came with a lighter edge, and replaces that suitor with a CAS; the
+// displaced suitor is then handled by the same thread, which makes it propose
+// again. A vertex is never displaced by a lighter edge, so a vertex only
+// moves down its neighbor list, sorted once by decreasing key, and the total
+// work is O(m log m). There are no synchronous rounds: on inputs such as a
+// path with monotone weights, where the greedy matching is decided one edge
+// at a time from the heavy end, a round-based algorithm needs a round per
+// matched edge, while here a single thread follows the chain of
+// displacements. The graph is not modified.
+namespace gbbs {
+namespace weighted_mm {
+
+template <class W> using edge = std::tuple<uintE, uintE, W>;
+
+template <class W> using edge_key = std::tuple<W, size_t, size_t>;
+
+template <class W>
+inline edge_key<W> key_of(uintE u, uintE v, W w, pbbslib::random r) {
+    size_t endpoints =
+        (static_cast<size_t>(std::min(u, v)) << 32) + std::max(u, v);
+    return edge_key<W>(w, mm::key_for_pair(u, v, r), endpoints);
+}
+
+// The neighbors of every vertex, with the keys of the edges to them, sorted
+// by decreasing key, in CSR form.
+template <class W> struct sorted_neighbors {
+    using entry = std::pair<edge_key<W>, uintE>;
+    sequence<size_t> offsets;
+    sequence<entry> E;
+
+    template <class Graph>
+    sorted_neighbors(Graph &G, pbbslib::random r) {
+        size_t n = G.n;
+        offsets = sequence<size_t>(n + 1, [&](size_t u) {
+            return (u == n) ? 0 : (size_t)G.get_vertex(u).out_degree();
+        });
+        pbbslib::scan_add_inplace(offsets);
+        E = sequence<entry>(offsets[n]);
+        parallel_for(
+            0, n,
+            [&](size_t u) {
+                size_t k = offsets[u];
+                auto map_f = [&](const uintE &u_, const uintE &v,
+                                 const W &w) {
+                    E[k++] = entry(key_of(u_, v, w, r), v);
+                };
+                G.get_vertex(u).out_neighbors().map(map_f, false);
+                std::sort(E.begin() + offsets[u], E.begin() + k,
+                          [](const entry &a, const entry &b) {
+                              return a.first > b.first;
+                          });
+            },
+            1);
+    }
+
+    // The index in E of u in the list of v, where k is the key of (u, v).
+    size_t position(uintE v, const edge_key<W> &k) const {
+        auto it = std::lower_bound(
+            E.begin() + offsets[v], E.begin() + offsets[v + 1], k,
+            [](const entry &a, const edge_key<W> &b) { return a.first > b; });
+        return it - E.begin();
+    }
+};
+
+} // namespace weighted_mm
+
+// Returns the edges of the greedy (locally dominant) matching of G, each once,
+// with the first endpoint the smaller one.
+template <template <class W> class vertex, class W>
+inline sequence<weighted_mm::edge<W>>
+WeightedMatching(symmetric_graph<vertex, W> &G) {
+    using edge = weighted_mm::edge<W>;
+    size_t n = G.n;
+    auto r = pbbslib::random();
+    auto L = weighted_mm::sorted_neighbors<W>(G, r);
+    auto &offsets = L.offsets;
+
+    // suitor[v] is the index in L.E of the current suitor in the list of v,
+    // or offsets[v + 1] if v has none; next[u] is the index of the next
+    // neighbor u proposes to.
+    auto suitor =
+        sequence<size_t>(n, [&](size_t v) { return offsets[v + 1]; });
+    auto next = sequence<size_t>(n, [&](size_t u) { return offsets[u]; });
+
+    parallel_for(
+        0, n,
+        [&](size_t s) {
+            uintE u = s;
+            while (u != UINT_E_MAX) {
+                uintE displaced = UINT_E_MAX;
+                while (next[u] < offsets[u + 1]) {
+                    auto &[key, v] = L.E[next[u]++];
+                    if (v == u) {
+                        continue;
+                    }
+                    size_t pos = L.position(v, key);
+                    size_t current = suitor[v];
+                    while (pos < current &&
+                           !pbbslib::atomic_compare_and_swap(&suitor[v],
+                                                             current, pos)) {
+                        current = suitor[v];
+                    }
+                    if (pos < current) {
+                        if (current < offsets[v + 1]) {
+                            displaced = L.E[current].second;
+                        }
+                        break;
+                    }
+                }
+                u = displaced;
+            }
+        },
+        1);
+
+    // At the end every suitor relation is mutual.
+    auto partner = [&](size_t u) {
+        size_t s = suitor[u];
+        return (s == offsets[u + 1]) ? UINT_E_MAX : L.E[s].second;
+    };
+    auto is_first = pbbs::delayed_seq<bool>(n, [&](size_t u) {
+        uintE v = partner(u);
+        return v != UINT_E_MAX && u < v && partner(v) == u;
+    });
+    auto first = pbbs::pack_index<uintE>(is_first);
+    return sequence<edge>(first.size(), [&](size_t i) {
+        uintE u = first[i];
+        return edge(u, partner(u), std::get<0>(L.E[suitor[u]].first));
+    });
+}
+
+// Checks that matching is a matching of G and that it is locally dominant:
+// every edge of G has an endpoint matched by an edge at least as heavy. This
+// implies maximality and that the weight is at least half the maximum.
+template <template <class W> class vertex, class W, class Seq>
+inline bool verify_weighted_matching(symmetric_graph<vertex, W> &G,
+                                     Seq &matching) {
+    size_t n = G.n;
+    auto matched = sequence<uintE>(n, [](size_t i) { return 0; });
+    auto match_weight = sequence<W>(n);
+    par_for(0, matching.size(), [&](size_t i) {
+        const auto &e = matching[i];
+        pbbslib::write_add(&matched[std::get<0>(e)], 1);
+        pbbslib::write_add(&matched[std::get<1>(e)], 1);
+        match_weight[std::get<0>(e)] = std::get<2>(e);
+        match_weight[std::get<1>(e)] = std::get<2>(e);
+    });
+    size_t conflicts = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        n, [&](size_t i) { return (size_t)(matched[i] > 1); }));
+    if (conflicts > 0) {
+        std::cout << "Matching invalid---" << conflicts
+                  << " vertices are matched more than once." << std::endl;
+        return false;
+    }
+
+    auto dominated = [&](uintE u, W w) {
+        return matched[u] && !(match_weight[u] < w);
+    };
+    auto bad = sequence<size_t>(n, [&](size_t u) {
+        auto count_f = [&](const uintE &src, const uintE &ngh, const W &wgh) {
+            return (size_t)(src != ngh && !dominated(src, wgh) &&
+                            !dominated(ngh, wgh));
+        };
+        auto monoid = pbbs::addm<size_t>();
+        return G.get_vertex(u).out_neighbors().reduce(count_f, monoid);
+    });
+    size_t n_bad = pbbslib::reduce_add(bad);
+    if (n_bad > 0) {
+        std::cout << "Matching not locally dominant---" << n_bad
+                  << " edges are heavier than the matched edges at both "
+                     "endpoints."
+                  << std::endl;
+        return false;
+    }
+    std::cout << "Matching OK! matching size is: " << matching.size()
+              << std::endl;
+    return true;
+}
+
+} // namespace gbbs
@@ -0,0 +1,66 @@
+#include "benchmarks/MaximalMatching/LocallyDominant/WeightedMatching.h"
+
+#include <tuple>
+
+#include "gbbs/graph.h"
+#include "gbbs/macros.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using ::testing::ElementsAre;
+
+namespace gbbs {
+
+namespace {
+
+using Edge = std::tuple<uintE, uintE, intE>;
+
+// Makes a symmetric weighted graph from a list of undirected edges.
+symmetric_graph<symmetric_vertex, intE>
+MakeWeightedGraph(uintE num_vertices, const std::vector<Edge> &edges) {
+    pbbs::sequence<Edge> both(2 * edges.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        auto [u, v, w] = edges[i];
+        both[2 * i] = Edge(u, v, w);
+        both[2 * i + 1] = Edge(v, u, w);
+    }
+    pbbs::sample_sort_inplace(both.slice(), std::less<Edge>());
+    constexpr bool kEdgesAreSorted{true};
+    return sym_graph_from_edges(both, num_vertices, kEdgesAreSorted);
+}
+
+} // namespace
+
+TEST(WeightedMatching, BasicUsage) {
+    // Graph diagram (edge weights in parentheses):
+    //     0 -(3)- 1
+    //     |       |
+    //    (1)     (5)
+    //     |       |
+    //     3 -(4)- 2
+    auto graph{MakeWeightedGraph(4, {{0, 1, 3}, {1, 2, 5}, {2, 3, 4},
+                                     {0, 3, 1}})};
+    auto matching{WeightedMatching(graph)};
+    EXPECT_THAT(matching, ElementsAre(Edge(0, 3, 1), Edge(1, 2, 5)));
+    EXPECT_TRUE(verify_weighted_matching(graph, matching));
+}
+
+TEST(WeightedMatching, LongMonotonePath) {
+    // A path whose edge weights increase along it. The greedy matching takes
+    // the heaviest remaining edge at the end of the path each time, so it is
+    // decided one edge at a time.
+    constexpr uintE kNumVertices{200000};
+    std::vector<Edge> edges;
+    for (uintE i = 0; i + 1 < kNumVertices; i++) {
+        edges.emplace_back(i, i + 1, i + 1);
+    }
+    auto graph{MakeWeightedGraph(kNumVertices, edges)};
+    auto matching{WeightedMatching(graph)};
+    ASSERT_EQ(matching.size(), kNumVertices / 2);
+    for (size_t i = 0; i < matching.size(); i++) {
+        EXPECT_EQ(matching[i], Edge(2 * i, 2 * i + 1, 2 * i + 1));
+    }
+    EXPECT_TRUE(verify_weighted_matching(graph, matching));
+}
+
+} // namespace gbbs
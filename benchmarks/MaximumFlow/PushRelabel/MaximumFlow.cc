@@ -0,0 +1,56 @@
+// Usage:
+// numactl -i all ./MaximumFlow -src 1 -sink 2 -rounds 1 twitter_wgh_J
+// flags:
+//   required:
+//     -src : the source
+//     -sink : the sink
+//   optional:
+//     -s : indicate that the graph is symmetric
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -check : check that the cut found has the capacity of the flow
+//     -rounds : the number of times to run the algorithm
+
+#include "MaximumFlow.h"
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("maximum_flow.txt");
+#endif
+
+template <class Graph> double MaximumFlow_runner(Graph &G, commandLine P) {
+    uintE src = P.getOptionLongValue("-src", 0);
+    uintE sink = P.getOptionLongValue("-sink", G.n - 1);
+    std::cout << "### Application: MaximumFlow (Push-Relabel)" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -src = " << src << " -sink = " << sink
+              << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+
+    if (src == sink || src >= G.n || sink >= G.n) {
+        std::cout << "# -src and -sink must be distinct vertices" << std::endl;
+        exit(-1);
+    }
+    timer t;
+    t.start();
+    auto result = MaximumFlow(G, src, sink);
+    double tt = t.stop();
+
+    size_t source_side = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        G.n, [&](size_t i) { return (size_t)result.source_side[i]; }));
+    std::cout << "### Flow value: " << result.flow << std::endl;
+    std::cout << "### Source side: " << source_side << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+    if (P.getOption("-check")) {
+        verify_flow(G, src, sink, result);
+    }
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_weighted_main(gbbs::MaximumFlow_runner, false);
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <type_traits>
+
+#include "gbbs/gbbs.h"
+#include "pbbslib/histogram.h"
+
+// Maximum s-t flow and minimum s-t cut with synchronous push-relabel (the
+// round-based scheme of Baumstark, Blelloch and Shun).
+//
+// Every arc (u, v, c) of the input is a pair p of residual arcs, u -> v with
+// capacity c and v -> u with capacity 0. The residual graph is kept as a
+// symmetric graph whose edges carry the pair id, so the same edge tells both
+// endpoints which pair (and hence which residual arc) it is, and edgeMap can
+// run on it in either direction.
+//
+// Every round, all active vertices push their excess (as of the start of the
+// round) along admissible arcs, h(u) = h(v) + 1, in one edgeMap; two
+// endpoints of a pair can never both see their arc as admissible, so each
+// residual arc has a single writer. A vertex left with excess has saturated
+// every admissible arc and is relabeled to one more than its lowest residual
+// neighbor, using the heights from before the relabels; if that empties a
+// height, every vertex above it is cut off from t (the gap heuristic) and is
+// lifted to n. Vertices that received flow form the next frontier, along
+// with those still holding excess. Global relabeling sets every height to
+// the residual distance to t with a reverse BFS over the residual graph (also
+// an edgeMap), and runs whenever the relabeling work since the last one
+// exceeds alpha * n + m.
+//
+// Only the first phase of push-relabel is run: it computes a maximum preflow,
+// whose excess at t is the maximum flow value, and the vertices that cannot
+// reach t in its residual graph form the source side of a minimum cut.
+namespace gbbs {
+namespace push_relabel {
+
+using flow_t = int64_t;
+
+constexpr size_t kGlobalRelabelAlpha = 6;
+constexpr size_t kRelabelWork = 12;
+
+template <class W> struct residual_network {
+    symmetric_graph<symmetric_vertex, uintT> G; // edges carry pair ids
+    sequence<uintE> tail;                       // tail of the input arc of p
+    sequence<W> residual; // 2p: along the input arc, 2p + 1: against it
+
+    // The residual arc leaving u in pair p.
+    inline uintT arc(uintT p, uintE u) const {
+        return 2 * p + (u == tail[p] ? 0 : 1);
+    }
+};
+
+// Builds the residual network of G. Only out-edges are read, so G can be
+// compressed; a symmetric G gives every edge both directions. Self-loops and
+// non-positive capacities are dropped.
+template <class Graph>
+inline residual_network<typename Graph::weight_type>
+BuildResidualNetwork(Graph &G) {
+    using W = typename Graph::weight_type;
+    using arc = std::tuple<uintE, uintE, W>;
+    size_t n = G.n;
+    auto offsets = sequence<size_t>(n + 1, [&](size_t i) {
+        return (i == n) ? 0 : G.get_vertex(i).out_degree();
+    });
+    size_t m = pbbslib::scan_add_inplace(offsets.slice());
+    auto arcs = sequence<arc>(m);
+    par_for(0, n, 1, [&](size_t u) {
+        size_t k = offsets[u];
+        auto f = [&](const uintE &src, const uintE &ngh, const W &w) {
+            arcs[k++] = std::make_tuple(src, ngh, w);
+        };
+        G.get_vertex(u).out_neighbors().map(f, false);
+    });
+    auto kept = pbbs::filter(arcs, [](const arc &a) {
+        return std::get<0>(a) != std::get<1>(a) && std::get<2>(a) > 0;
+    });
+    arcs.clear();
+
+    size_t num_pairs = kept.size();
+    residual_network<W> R;
+    R.tail = sequence<uintE>(num_pairs,
+                             [&](size_t p) { return std::get<0>(kept[p]); });
+    R.residual = sequence<W>(2 * num_pairs, [&](size_t i) {
+        return (i % 2 == 0) ? std::get<2>(kept[i / 2]) : (W)0;
+    });
+    using entry = std::tuple<uintE, uintE, uintT>;
+    auto entries = sequence<entry>(2 * num_pairs, [&](size_t i) {
+        const auto &a = kept[i / 2];
+        uintE u = std::get<0>(a), v = std::get<1>(a);
+        return (i % 2 == 0) ? std::make_tuple(u, v, (uintT)(i / 2))
+                            : std::make_tuple(v, u, (uintT)(i / 2));
+    });
+    R.G = sym_graph_from_edges<uintT>(entries, n);
+    return R;
+}
+
+// Reverse BFS from t: a vertex w is reached from v when the residual arc
+// w -> v has capacity left, and gets the height of the current level.
+template <class W> struct reverse_bfs_F {
+    residual_network<W> &R;
+    uintE *height;
+    uintE level;
+    uintE unreached;
+    uintE s;
+
+    reverse_bfs_F(residual_network<W> &R, uintE *height, uintE level,
+                  uintE unreached, uintE s)
+        : R(R), height(height), level(level), unreached(unreached), s(s) {}
+
+    inline bool update(const uintE &v, const uintE &w, const uintT &p) {
+        if (R.residual[R.arc(p, w)] > 0) {
+            height[w] = level;
+            return true;
+        }
+        return false;
+    }
+    inline bool updateAtomic(const uintE &v, const uintE &w, const uintT &p) {
+        return R.residual[R.arc(p, w)] > 0 &&
+               pbbslib::atomic_compare_and_swap(&height[w], unreached, level);
+    }
+    inline bool cond(const uintE &w) const {
+        return height[w] == unreached && w != s;
+    }
+};
+
+// Sets every height to the residual distance to t, or n if t is unreachable
+// (and for s).
+template <class W>
+inline void GlobalRelabel(residual_network<W> &R, sequence<uintE> &height,
+                          uintE s, uintE t) {
+    size_t n = R.G.n;
+    par_for(0, n, pbbslib::kSequentialForThreshold,
+            [&](size_t i) { height[i] = n; });
+    height[t] = 0;
+    vertexSubset frontier(n, t);
+    uintE level = 1;
+    while (!frontier.isEmpty()) {
+        auto F = reverse_bfs_F<W>(R, height.begin(), level, n, s);
+        vertexSubset output = edgeMap(R.G, frontier, F);
+        frontier.del();
+        frontier = output;
+        level++;
+    }
+    frontier.del();
+}
+
+// Gap relabeling: no vertex is left at height gap < n, so no vertex above it
+// can reach t, and all of them are lifted to n. count[h] is the number of
+// vertices at height h.
+inline void LiftAboveGap(sequence<uintE> &height, sequence<intE> &count,
+                         uintE gap) {
+    size_t n = height.size();
+    auto above = pbbs::delayed_seq<bool>(
+        n, [&](size_t v) { return height[v] > gap && height[v] < n; });
+    auto lifted = pbbs::pack_index<uintE>(above);
+    par_for(0, lifted.size(), [&](size_t i) { height[lifted[i]] = n; });
+    count[n] += lifted.size();
+    par_for(gap + 1, n, pbbslib::kSequentialForThreshold,
+            [&](size_t h) { count[h] = 0; });
+}
+
+// Pushes the excess an active vertex v had at the start of the round, held in
+// remaining[v], along admissible arcs. Returns true for vertices other than s
+// and t that first receive flow in this round.
+template <class W> struct push_F {
+    residual_network<W> &R;
+    uintE *height;
+    flow_t *excess;
+    flow_t *remaining;
+    uintE *last_round;
+    uintE round;
+    uintE s, t;
+
+    push_F(residual_network<W> &R, uintE *height, flow_t *excess,
+           flow_t *remaining, uintE *last_round, uintE round, uintE s, uintE t)
+        : R(R), height(height), excess(excess), remaining(remaining),
+          last_round(last_round), round(round), s(s), t(t) {}
+
+    inline bool updateAtomic(const uintE &v, const uintE &w, const uintT &p) {
+        if (height[v] != height[w] + 1) {
+            return false;
+        }
+        uintT a = R.arc(p, v);
+        flow_t capacity = R.residual[a];
+        if (capacity <= 0) {
+            return false;
+        }
+        flow_t delta;
+        while (true) {
+            flow_t rem = remaining[v];
+            if (rem <= 0) {
+                return false;
+            }
+            delta = std::min(rem, capacity);
+            if (pbbslib::atomic_compare_and_swap(&remaining[v], rem,
+                                                 rem - delta)) {
+                break;
+            }
+        }
+        R.residual[a] -= delta;
+        R.residual[a ^ 1] += delta;
+        pbbslib::write_add(&excess[w], delta);
+        if (w == s || w == t) {
+            return false;
+        }
+        uintE last = last_round[w];
+        return last != round &&
+               pbbslib::atomic_compare_and_swap(&last_round[w], last, round);
+    }
+    // Pushes of one vertex can run on several threads even in dense mode.
+    inline bool update(const uintE &v, const uintE &w, const uintT &p) {
+        return updateAtomic(v, w, p);
+    }
+    inline bool cond(const uintE &w) const { return true; }
+};
+
+} // namespace push_relabel
+
+template <class W> struct flow_result {
+    push_relabel::flow_t flow;
+    sequence<bool> source_side; // the source side of a minimum s-t cut
+};
+
+// Computes a maximum s-t flow value of G, whose edge weights are capacities,
+// and a minimum s-t cut.
+template <class Graph>
+inline flow_result<typename Graph::weight_type> MaximumFlow(Graph &G, uintE s,
+                                                            uintE t) {
+    using W = typename Graph::weight_type;
+    using push_relabel::flow_t;
+    static_assert(std::is_integral<W>::value, "capacities must be integral");
+    size_t n = G.n;
+
+    timer build_t;
+    build_t.start();
+    auto R = push_relabel::BuildResidualNetwork(G);
+    build_t.stop();
+    build_t.reportTotal("residual network time");
+
+    auto height = sequence<uintE>(n);
+    auto excess = sequence<flow_t>(n, (flow_t)0);
+    auto remaining = sequence<flow_t>(n, (flow_t)0);
+    auto last_round = sequence<uintE>(n, UINT_E_MAX);
+    sequence<intE> count;
+
+    // Saturate the arcs leaving s.
+    auto source = R.G.get_vertex(s).out_neighbors();
+    for (size_t i = 0; i < R.G.get_vertex(s).out_degree(); i++) {
+        uintE w = source.get_neighbor(i);
+        uintT a = R.arc(source.get_weight(i), s);
+        excess[w] += R.residual[a];
+        R.residual[a ^ 1] += R.residual[a];
+        R.residual[a] = 0;
+    }
+
+    size_t global_relabel_work =
+        push_relabel::kGlobalRelabelAlpha * n + R.G.m;
+    size_t relabel_work = global_relabel_work;
+    size_t rounds = 0, global_relabels = 0;
+    vertexSubset active(n);
+    while (true) {
+        if (relabel_work >= global_relabel_work) {
+            push_relabel::GlobalRelabel(R, height, s, t);
+            count = pbbs::histogram<intE>(height, n + 1);
+            relabel_work = 0;
+            global_relabels++;
+            auto is_active = pbbs::delayed_seq<bool>(n, [&](size_t v) {
+                return v != s && v != t && excess[v] > 0 && height[v] < n;
+            });
+            auto next = pbbs::pack_index<uintE>(is_active);
+            active.del();
+            active = vertexSubset(n, next);
+        }
+        if (active.isEmpty()) {
+            break;
+        }
+        active.toSparse();
+        size_t k = active.size();
+        auto frontier = sequence<uintE>(k, [&](size_t i) {
+            return active.vtx(i);
+        });
+        auto start_excess = sequence<flow_t>(k, [&](size_t i) {
+            remaining[frontier[i]] = excess[frontier[i]];
+            return excess[frontier[i]];
+        });
+
+        auto F = push_relabel::push_F<W>(R, height.begin(), excess.begin(),
+                                          remaining.begin(),
+                                          last_round.begin(), rounds, s, t);
+        // Pushing gains nothing from pulling: every target passes cond.
+        vertexSubset received = edgeMap(R.G, active, F, -1, no_dense);
+        received.toSparse();
+        par_for(0, k, [&](size_t i) {
+            uintE v = frontier[i];
+            excess[v] -= start_excess[i] - remaining[v];
+        });
+
+        // Relabel the vertices left with excess, from the old heights.
+        auto new_height = sequence<uintE>(k, [&](size_t i) {
+            uintE v = frontier[i];
+            if (remaining[v] <= 0) {
+                return height[v];
+            }
+            uintE h = n;
+            auto nghs = R.G.get_vertex(v).out_neighbors();
+            for (size_t j = 0; j < R.G.get_vertex(v).out_degree(); j++) {
+                if (R.residual[R.arc(nghs.get_weight(j), v)] > 0) {
+                    h = std::min(h, height[nghs.get_neighbor(j)] + 1);
+                }
+            }
+            return std::min(h, (uintE)n);
+        });
+        auto work = pbbs::delayed_seq<size_t>(k, [&](size_t i) {
+            uintE v = frontier[i];
+            return (remaining[v] > 0) ? R.G.get_vertex(v).out_degree() +
+                                            push_relabel::kRelabelWork
+                                      : 0;
+        });
+        relabel_work += pbbslib::reduce_add(work);
+        auto old_height = sequence<uintE>(k, [&](size_t i) {
+            uintE v = frontier[i];
+            uintE h = height[v];
+            if (new_height[i] != h) {
+                pbbslib::write_add(&count[h], -1);
+                pbbslib::write_add(&count[new_height[i]], 1);
+                height[v] = new_height[i];
+            }
+            return h;
+        });
+        auto gaps = pbbs::filter(old_height, [&](uintE h) {
+            return h < n && count[h] == 0;
+        });
+        if (gaps.size() > 0) {
+            uintE gap = pbbs::reduce(gaps, pbbs::minm<uintE>());
+            push_relabel::LiftAboveGap(height, count, gap);
+            relabel_work += n;
+        }
+
+        // The next frontier: vertices that received flow and vertices still
+        // holding excess, excluding those that can no longer reach t.
+        auto still_active = pbbs::filter(frontier, [&](uintE v) {
+            return last_round[v] != rounds && excess[v] > 0 && height[v] < n;
+        });
+        auto reached = pbbs::filter(
+            pbbs::delayed_seq<uintE>(received.size(),
+                                     [&](size_t i) { return received.vtx(i); }),
+            [&](uintE w) { return height[w] < n; });
+        received.del();
+        auto next = sequence<uintE>(
+            still_active.size() + reached.size(), [&](size_t i) {
+                return (i < still_active.size())
+                           ? still_active[i]
+                           : reached[i - still_active.size()];
+            });
+        active.del();
+        active = vertexSubset(n, next);
+        rounds++;
+    }
+    active.del();
+    std::cout << "# rounds = " << rounds
+              << ", global relabels = " << global_relabels << std::endl;
+
+    push_relabel::GlobalRelabel(R, height, s, t);
+    flow_result<W> result;
+    result.flow = excess[t];
+    result.source_side =
+        sequence<bool>(n, [&](size_t v) { return height[v] >= n; });
+    R.G.del();
+    return result;
+}
+
+// Checks that s and t are separated and that the capacity of the cut equals
+// the flow value, which certifies that both are optimal.
+template <class Graph>
+inline bool verify_flow(Graph &G, uintE s, uintE t,
+                        flow_result<typename Graph::weight_type> &result) {
+    using W = typename Graph::weight_type;
+    using push_relabel::flow_t;
+    auto &S = result.source_side;
+    auto cut = sequence<flow_t>(G.n, [&](size_t u) {
+        flow_t sum = 0;
+        if (S[u]) {
+            auto f = [&](const uintE &src, const uintE &ngh, const W &w) {
+                if (!S[ngh] && w > 0) {
+                    sum += w;
+                }
+            };
+            G.get_vertex(u).out_neighbors().map(f, false);
+        }
+        return sum;
+    });
+    flow_t cut_capacity = pbbslib::reduce_add(cut);
+    if (!S[s] || S[t] || cut_capacity != result.flow) {
+        std::cout << "Flow invalid---cut capacity " << cut_capacity
+                  << ", flow " << result.flow << std::endl;
+        return false;
+    }
+    std::cout << "Flow OK! cut capacity equals the flow value" << std::endl;
+    return true;
+}
+
+} // namespace gbbs
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <utility>
+
+#include "gbbs/gbbs.h"
+#include "gbbs/pbbslib/dyn_arr.h"
+#include "gbbs/speculative_for.h"
+#include "gbbs/union_find.h"
+
+#include "pbbslib/binary_search.h"
+#include "pbbslib/random.h"
+#include "pbbslib/sample_sort.h"
+
+// Filter-Kruskal (Osipov, Sanders and Singler) run directly on the graph.
+//
+// Every round takes a sampled pivot such that about n of the remaining edges
+// are lighter, and moves the lighter edges out of the graph with
+// filter_edges; the rest of the graph is never materialized as an edge
+// array, so the graph can be compressed. The light edges are solved by
+// recursive Filter-Kruskal in memory: partition around a sampled pivot,
+// solve the light side, drop the heavy edges whose endpoints are already
+// connected, and solve the heavy side. Small sets are sorted and added with
+// the speculative union-find step of gbbs/union_find.h. After each round, the
+// edges of the graph whose endpoints are already connected are packed out.
+//
+// Edges are ordered by weight and then by a hash of their endpoints, so that
+// pivots split long runs of equal weights and every round makes progress.
+// Like the other MinimumSpanningForest implementations, this mutates the
+// graph.
+namespace gbbs {
+namespace MinimumSpanningForest_filter_kruskal {
+
+constexpr size_t kBaseCaseSize = 1 << 14;
+constexpr size_t kSampleSize = 1024;
+
+inline size_t edge_hash(uintE u, uintE v) {
+    size_t key = (static_cast<size_t>(std::min(u, v)) << 32UL) +
+                 static_cast<size_t>(std::max(u, v));
+    return pbbs::hash64(key);
+}
+
+template <class W> inline std::pair<W, size_t> edge_key(uintE u, uintE v, W w) {
+    return std::make_pair(w, edge_hash(u, v));
+}
+
+template <class W> using edge = std::tuple<uintE, uintE, W>;
+
+template <class W> inline std::pair<W, size_t> edge_key(const edge<W> &e) {
+    return edge_key(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+}
+
+// The view of a range of edges expected by UnionFindStep.
+template <class W> struct edge_range {
+    edge<W> *E;
+    size_t non_zeros;
+};
+
+// The union-find structure, the reservations of the speculative union-find
+// step (which are all reset when a step finishes, so they are reused), and
+// the forest built so far.
+template <class W> struct forest_state {
+    UnionFind uf;
+    sequence<reservation<uintE>> R;
+    pbbslib::dyn_arr<edge<W>> forest;
+
+    forest_state(size_t n)
+        : uf(n), R(n, [](size_t i) { return reservation<uintE>(); }),
+          forest(n) {}
+};
+
+// Sorts the edges and adds the ones joining different trees to the forest.
+template <class W>
+inline void KruskalBase(range<edge<W> *> edges, forest_state<W> &S) {
+    size_t m = edges.size();
+    pbbs::sample_sort_inplace(edges, [](const edge<W> &a, const edge<W> &b) {
+        return edge_key(a) < edge_key(b);
+    });
+    auto in_forest = sequence<bool>(m, false);
+    auto E = edge_range<W>{edges.begin(), m};
+    auto step = make_uf_step<uintE>(E, S.R.begin(), in_forest, S.uf);
+    speculative_for<uintE>(step, 0, m, 8);
+    step.clear();
+    auto added = pbbs::pack(edges, in_forest);
+    S.forest.copyIn(added, added.size());
+}
+
+template <class W>
+inline void FilterKruskal(range<edge<W> *> edges, forest_state<W> &S,
+                          pbbs::random r) {
+    size_t m = edges.size();
+    if (m <= kBaseCaseSize) {
+        KruskalBase(edges, S);
+        return;
+    }
+    auto samples = sequence<std::pair<W, size_t>>(kSampleSize, [&](size_t i) {
+        return edge_key(edges[r.ith_rand(i) % m]);
+    });
+    pbbs::sample_sort_inplace(samples.slice(),
+                              std::less<std::pair<W, size_t>>());
+    auto pivot = samples[kSampleSize / 2];
+    auto heavy_flags = pbbs::delayed_seq<bool>(
+        m, [&](size_t i) { return pivot < edge_key(edges[i]); });
+    auto [split, num_light] = pbbs::split_two(edges, heavy_flags);
+    if (num_light == 0 || num_light == m) {
+        // Only possible with (pathologically) equal keys.
+        KruskalBase(edges, S);
+        return;
+    }
+    FilterKruskal(split.slice(0, num_light), S, r.fork(0));
+    // Drop the heavy edges whose endpoints the light side connected.
+    auto heavy = pbbs::filter(split.slice(num_light, m), [&](const edge<W> &e) {
+        return S.uf.find(std::get<0>(e)) != S.uf.find(std::get<1>(e));
+    });
+    split.clear();
+    FilterKruskal(heavy.slice(), S, r.fork(1));
+}
+
+// A pivot key such that about k of the G.m / 2 undirected edges of G are
+// lighter, from a sample of edges picked uniformly at random.
+template <class Graph>
+inline std::pair<typename Graph::weight_type, size_t>
+SamplePivot(Graph &G, size_t k, pbbs::random r) {
+    using W = typename Graph::weight_type;
+    size_t n = G.n;
+    auto offsets = sequence<size_t>(
+        n, [&](size_t i) { return G.get_vertex(i).out_degree(); });
+    size_t m = pbbslib::scan_add_inplace(offsets.slice());
+    auto samples = sequence<std::pair<W, size_t>>(kSampleSize, [&](size_t i) {
+        size_t e = r.ith_rand(i) % m;
+        // The last vertex whose offset is at most e.
+        size_t u = pbbslib::binary_search(offsets, e + 1,
+                                          std::less<size_t>()) -
+                   1;
+        auto [v, w] =
+            G.get_vertex(u).out_neighbors().get_ith_neighbor(e - offsets[u]);
+        return edge_key((uintE)u, v, w);
+    });
+    pbbs::sample_sort_inplace(samples.slice(),
+                              std::less<std::pair<W, size_t>>());
+    size_t index = std::min(kSampleSize - 1, k * kSampleSize / (m / 2));
+    return samples[index];
+}
+
+// Returns the edges of a minimum spanning forest of GA, each once.
+template <template <class W> class vertex, class W,
+          typename std::enable_if<!std::is_same<W, pbbslib::empty>::value,
+                                  int>::type = 0>
+inline sequence<edge<W>> MinimumSpanningForest(symmetric_graph<vertex, W> &GA) {
+    size_t n = GA.n;
+    auto r = pbbs::random();
+    auto S = forest_state<W>(n);
+
+    size_t round = 0;
+    while (GA.m > 0) {
+        size_t k = std::max(n, kBaseCaseSize);
+        edge_array<W> light;
+        if (GA.m / 2 <= k) {
+            auto all = [&](const uintE &u, const uintE &v, const W &w) {
+                return (u < v) ? 2 : 1;
+            };
+            light = filter_edges(GA, all);
+        } else {
+            auto pivot = SamplePivot(GA, k, r.fork(2 * round));
+            auto lighter = [&](const uintE &u, const uintE &v, const W &w) {
+                if (pivot < edge_key(u, v, w)) {
+                    return 0;
+                }
+                return (u < v) ? 2 : 1;
+            };
+            light = filter_edges(GA, lighter);
+        }
+        auto light_edges = sequence<edge<W>>(light.E, light.non_zeros);
+        FilterKruskal(light_edges.slice(), S, r.fork(2 * round + 1));
+        light_edges.clear();
+
+        auto connected = [&](const uintE &u, const uintE &v, const W &w) {
+            return (int)(S.uf.find(u) == S.uf.find(v));
+        };
+        filter_edges(GA, connected, no_output);
+        round++;
+    }
+    S.uf.clear();
+    auto edges = sequence<edge<W>>(S.forest.size,
+                                   [&](size_t i) { return S.forest.A[i]; });
+    S.forest.del();
+    return edges;
+}
+
+template <template <class W> class vertex, class W,
+          typename std::enable_if<std::is_same<W, pbbslib::empty>::value,
+                                  int>::type = 0>
+inline sequence<edge<W>> MinimumSpanningForest(symmetric_graph<vertex, W> &GA) {
+    std::cout << "Unimplemented for unweighted graphs"
+              << "\n";
+    exit(0);
+}
+
+} // namespace MinimumSpanningForest_filter_kruskal
+} // namespace gbbs
@@ -26,15 +26,28 @@
 // flags:
 //   optional:
 //     -eps : the epsilon to use for convergence (1e-6 by default)
+//     -spmv : use the CSR SpMV engine (uncompressed graphs only), with
+//       -float : store ranks and contributions as float
+//       -gs : update ranks in place (Gauss-Seidel) instead of synchronously
 //     -rounds : the number of times to run the algorithm
 //     -c : indicate that the graph is compressed
 //     -m : indicate that the graph should be mmap'd
 //     -s : indicate that the graph is symmetric
 
 #include "PageRank.h"
+#include "PageRankSpMV.h"
 
 namespace gbbs {
 
+template <class Real> void report_spmv(const pr_spmv::pr_result<Real> &r) {
+    for (auto &it : r.trace) {
+        std::cout << "# iter = " << it.iter << " L1_norm = " << it.l1_residual
+                  << " time = " << it.time << std::endl;
+    }
+    auto max_pr = pbbslib::reduce_max(r.p);
+    std::cout << "max_pr = " << max_pr << std::endl;
+}
+
 template <class Graph> double PageRank_runner(Graph &G, commandLine P) {
     std::string stat_file = P.getOptionValue("-statFile", "");
     std::cout << "### Application: PageRank" << std::endl;
@@ -56,6 +69,13 @@ template <class Graph> double PageRank_runner(Graph &G, commandLine P) {
         access_observer.set_timer(&t);
 #endif
         PageRank_edgeMap(G, eps, iters);
+    } else if (P.getOptionValue("-spmv")) {
+        bool gs = P.getOptionValue("-gs");
+        if (P.getOptionValue("-float")) {
+            report_spmv(pr_spmv::PageRankSpMV<float>(G, eps, iters, gs));
+        } else {
+            report_spmv(pr_spmv::PageRankSpMV<double>(G, eps, iters, gs));
+        }
     } else if (P.getOptionValue("-delta")) {
         delta::PageRankDelta(G, eps, local_eps, iters);
     } else {
@@ -0,0 +1,75 @@
+// Usage:
+// numactl -i all ./PersonalizedPageRank -s -m -num_queries 64 twitter_SJ
+// flags:
+//   optional:
+//     -num_queries : the number of queries, each seeded at a random vertex
+//     -seed : the seed used to pick the query vertices
+//     -eps : the epsilon to use for convergence (1e-6 by default)
+//     -iters : the maximum number of iterations per batch of queries
+//     -float : store ranks as float
+//     -push : approximate each query locally by forward push, with
+//       -push_eps : the residual threshold per unit of degree (1e-4 by default)
+//     -rounds : the number of times to run the algorithm
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -s : indicate that the graph is symmetric
+
+#include "PersonalizedPageRank.h"
+
+namespace gbbs {
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("ppr.txt");
+#endif
+
+template <class Graph>
+double PersonalizedPageRank_runner(Graph &G, commandLine P) {
+    size_t num_queries = P.getOptionLongValue("-num_queries", 64);
+    size_t seed = P.getOptionLongValue("-seed", 0);
+    double eps = P.getOptionDoubleValue("-eps", 0.000001);
+    size_t iters = P.getOptionLongValue("-iters", 100);
+    bool push = P.getOptionValue("-push");
+    double push_eps = P.getOptionDoubleValue("-push_eps", 0.0001);
+    std::cout << "### Application: PersonalizedPageRank" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -num_queries = " << num_queries
+              << " -eps = " << eps << " -push = " << push
+              << " -push_eps = " << push_eps << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+
+    auto r = pbbslib::random(seed);
+    auto seeds = sequence<sequence<uintE>>(num_queries, [&](size_t j) {
+        return sequence<uintE>(1, (uintE)(r.ith_rand(j) % G.n));
+    });
+
+    timer t;
+    t.start();
+    if (push) {
+        auto estimates = ppr::ForwardPushPPR(G, seeds, push_eps);
+        double tt = t.stop();
+        auto touched = pbbslib::reduce_add(pbbslib::make_sequence<size_t>(
+            num_queries, [&](size_t j) { return estimates[j].size(); }));
+        std::cout << "# vertices with estimates (total) = " << touched
+                  << std::endl;
+        std::cout << "### Running Time: " << tt << std::endl;
+        return tt;
+    }
+    sequence<double> ranks;
+    if (P.getOptionValue("-float")) {
+        auto f = ppr::BatchedPersonalizedPageRank<float>(G, seeds, eps, iters);
+        ranks = sequence<double>(f.size(), [&](size_t i) { return f[i]; });
+    } else {
+        ranks = ppr::BatchedPersonalizedPageRank<double>(G, seeds, eps, iters);
+    }
+    double tt = t.stop();
+    std::cout << "max_ppr = " << pbbslib::reduce_max(ranks) << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_main(gbbs::PersonalizedPageRank_runner, false);
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+
+#include "PageRankSpMV.h"
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+namespace ppr {
+
+// The ranks (or contributions) of one vertex for kWidth queries. Operations
+// are fixed-length loops that the compiler vectorizes.
+template <class Real, size_t kWidth> struct rank_block {
+    static constexpr size_t width = kWidth;
+    Real v[kWidth];
+
+    rank_block() {}
+    explicit rank_block(Real x) {
+        for (size_t j = 0; j < kWidth; j++)
+            v[j] = x;
+    }
+    inline rank_block operator+(const rank_block &o) const {
+        rank_block b;
+        for (size_t j = 0; j < kWidth; j++)
+            b.v[j] = v[j] + o.v[j];
+        return b;
+    }
+    inline rank_block operator*(Real x) const {
+        rank_block b;
+        for (size_t j = 0; j < kWidth; j++)
+            b.v[j] = v[j] * x;
+        return b;
+    }
+};
+
+// Personalized PageRank for a batch of queries: query j restarts uniformly
+// at a vertex of seeds[j], i.e. p_j = damping * A p_j + (1 - damping) e_j,
+// with A as in pr_spmv::PageRankSpMV.
+//
+// Queries are processed kWidth at a time. The ranks of a group are stored as
+// one rank_block per vertex, so each SpMV over the in-edges (with the pbbs CSR
+// kernel) advances all of the group's queries: an edge moves a block instead
+// of a scalar. A group stops once the L1 residual of every query is below
+// eps, or after max_iters iterations.
+//
+// Returns the ranks vertex-major: the rank of v for query j is at
+// [v * seeds.size() + j].
+template <class Real, size_t kWidth = 8, class Graph>
+inline sequence<Real>
+BatchedPersonalizedPageRank(Graph &G, const sequence<sequence<uintE>> &seeds,
+                            double eps = 0.000001, size_t max_iters = 100,
+                            double damping = 0.85) {
+    using block = rank_block<Real, kWidth>;
+    size_t n = G.n;
+    size_t m = G.m;
+    size_t k = seeds.size();
+    auto ranks = sequence<Real>(n * k, (Real)0);
+
+    vertex_data *offsets;
+    std::tuple<uintE, typename Graph::weight_type> *edges;
+    std::tie(offsets, edges) = pr_spmv::in_csr(G);
+    auto starts = pbbs::delayed_seq<size_t>(
+        n + 1, [&](size_t i) { return (i == n) ? m : offsets[i].offset; });
+    auto columns = pbbs::delayed_seq<uintE>(
+        m, [&](size_t j) { return std::get<0>(edges[j]); });
+    auto values = pbbs::delayed_seq<pbbs::empty>(
+        m, [](size_t j) { return pbbs::empty(); });
+    auto mult = [](const block &c, pbbs::empty) { return c; };
+    auto add = [](const block &a, const block &b) { return a + b; };
+
+    const Real d = damping;
+    auto inv_degree = sequence<Real>(n, [&](size_t i) {
+        uintE deg = G.get_vertex(i).out_degree();
+        return (deg == 0) ? (Real)0 : (Real)1 / deg;
+    });
+    // Allocated once and reused by every group.
+    auto restart = sequence<block>(n);
+    auto p = sequence<block>(n);
+    auto contrib = sequence<block>(n);
+    auto next_contrib = sequence<block>(n);
+    size_t P = num_workers();
+    auto residuals = sequence<block>(P);
+
+    for (size_t first = 0; first < k; first += kWidth) {
+        size_t width = std::min(kWidth, k - first);
+        parallel_for(0, n, [&](size_t i) {
+            restart[i] = block((Real)0);
+            p[i] = block((Real)0);
+        });
+        for (size_t j = 0; j < width; j++) {
+            auto &S = seeds[first + j];
+            for (size_t i = 0; i < S.size(); i++) {
+                restart[S[i]].v[j] += (1 - damping) / S.size();
+            }
+        }
+        // Start from the restart distribution.
+        parallel_for(0, n, [&](size_t i) {
+            p[i] = restart[i] * (Real)(1 / (1 - damping));
+            contrib[i] = p[i] * inv_degree[i];
+        });
+
+        for (size_t iter = 1; iter <= max_iters; iter++) {
+            parallel_for(0, P, [&](size_t i) { residuals[i] = block((Real)0); });
+            auto apply = [&](size_t v, const block &sum) {
+                block p_new = sum * d + restart[v];
+                block &res = residuals[worker_id()];
+                for (size_t j = 0; j < kWidth; j++)
+                    res.v[j] += fabs(p_new.v[j] - p[v].v[j]);
+                p[v] = p_new;
+                next_contrib[v] = p_new * inv_degree[v];
+            };
+            pbbs::mat_vec_mult_apply(starts, columns, values, contrib.slice(),
+                                     block((Real)0), mult, add, apply);
+            std::swap(contrib, next_contrib);
+
+            double worst = 0;
+            for (size_t j = 0; j < width; j++) {
+                double l1 = 0;
+                for (size_t i = 0; i < P; i++)
+                    l1 += residuals[i].v[j];
+                worst = std::max(worst, l1);
+            }
+            debug(std::cout << "queries " << first << ".." << first + width
+                            << " iter = " << iter << " L1_norm = " << worst
+                            << std::endl;);
+            if (worst < eps)
+                break;
+        }
+
+        parallel_for(0, n, [&](size_t v) {
+            for (size_t j = 0; j < width; j++)
+                ranks[v * k + first + j] = p[v].v[j];
+        });
+    }
+    return ranks;
+}
+
+// Approximate personalized PageRank of one query by forward push (Andersen,
+// Chung and Lang): residual mass r starts at the seeds, and a vertex u with
+// r[u] >= eps * out_degree(u) moves (1 - damping) r[u] into its estimate and
+// spreads damping * r[u] over its out-neighbors. Only vertices reached by a
+// push are stored, so the work depends on eps and the neighborhood of the
+// seeds, not on n. On return every residual r[u] is below eps *
+// out_degree(u), and the estimates fall short of the exact ranks by at most
+// the total remaining residual in L1.
+//
+// Returns the (vertex, estimate) pairs with a nonzero estimate.
+template <class Graph>
+inline sequence<std::pair<uintE, double>>
+ForwardPushPPR(Graph &G, const sequence<uintE> &seeds, double eps,
+               double damping = 0.85) {
+    using W = typename Graph::weight_type;
+    std::unordered_map<uintE, double> p;
+    std::unordered_map<uintE, double> r;
+    std::deque<uintE> queue;
+    auto above = [&](uintE u, double ru) {
+        return ru >= eps * std::max(G.get_vertex(u).out_degree(), (uintE)1);
+    };
+    for (size_t i = 0; i < seeds.size(); i++) {
+        r[seeds[i]] += 1.0 / seeds.size();
+    }
+    for (auto &kv : r) {
+        if (above(kv.first, kv.second))
+            queue.push_back(kv.first);
+    }
+    while (!queue.empty()) {
+        uintE u = queue.front();
+        queue.pop_front();
+        double ru = r[u];
+        if (!above(u, ru))
+            continue; // already pushed since it was queued
+        r[u] = 0;
+        p[u] += (1 - damping) * ru;
+        uintE deg = G.get_vertex(u).out_degree();
+        if (deg == 0)
+            continue;
+        double share = damping * ru / deg;
+        auto map_f = [&](const uintE &u_, const uintE &v, const W &wgh) {
+            double &rv = r[v];
+            bool was_above = above(v, rv);
+            rv += share;
+            if (!was_above && above(v, rv))
+                queue.push_back(v);
+        };
+        G.get_vertex(u).out_neighbors().map(map_f, false);
+    }
+    auto out = sequence<std::pair<uintE, double>>(p.size());
+    size_t i = 0;
+    for (auto &kv : p) {
+        out[i++] = kv;
+    }
+    return out;
+}
+
+// Runs ForwardPushPPR for every query in parallel.
+template <class Graph>
+inline sequence<sequence<std::pair<uintE, double>>>
+ForwardPushPPR(Graph &G, const sequence<sequence<uintE>> &seeds, double eps,
+               double damping = 0.85) {
+    return sequence<sequence<std::pair<uintE, double>>>(
+        seeds.size(),
+        [&](size_t j) { return ForwardPushPPR(G, seeds[j], eps, damping); });
+}
+
+} // namespace ppr
+} // namespace gbbs
@@ -13,7 +13,12 @@
 //       construction
 //     -mu : SCAN parameter mu
 //     -epsilon : SCAN parameter epsilon
+//     -index : path of an index file. If the file exists, the index is loaded
+//       from it instead of constructed; otherwise the constructed index is
+//       saved to it. Loading aborts if the file holds the index of a graph
+//       with a different number of vertices or edges.
 #include <string>
+#include <sys/stat.h>
 
 #include "benchmarks/SCAN/IndexBased/scan.h"
 #include "benchmarks/SCAN/IndexBased/similarity_measure.h"
@@ -31,9 +36,22 @@ template <class Graph> double RunScan(Graph &graph, commandLine parameters) {
     std::cout << "Scan parameters: mu = " << mu << ", epsilon = " << epsilon
               << '\n';
 
-    timer index_construction_timer{"Index construction time"};
-    const indexed_scan::Index scan_index{&graph, scan::CosineSimilarity{}};
+    const std::string index_file{parameters.getOptionValue("-index", "")};
+    struct stat index_file_stat;
+    const bool load_index{!index_file.empty() &&
+                          stat(index_file.c_str(), &index_file_stat) == 0};
+
+    timer index_construction_timer{load_index ? "Index load time"
+                                              : "Index construction time"};
+    const indexed_scan::Index scan_index{
+        load_index ? indexed_scan::Index::Load(index_file, &graph)
+                   : indexed_scan::Index{&graph, scan::CosineSimilarity{}}};
     index_construction_timer.stop();
+    if (!index_file.empty() && !load_index) {
+        timer index_save_timer{"Index save time"};
+        scan_index.Save(index_file);
+        index_save_timer.reportTotal("");
+    }
 
     timer cluster_timer{"Clustering time over " +
                         std::to_string(cluster_rounds) + " rounds"};
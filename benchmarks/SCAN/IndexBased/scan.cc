@@ -185,7 +185,26 @@ void AttachNoncoresToClustersDeterministic(
 } // namespace
 
 Index::Index()
-    : num_vertices_{0U}, neighbor_order_{}, core_order_{neighbor_order_} {}
+    : num_vertices_{0U}, num_edges_{0U}, neighbor_order_{},
+      core_order_{neighbor_order_} {}
+
+Index::Index(const size_t num_edges, internal::NeighborOrder &&neighbor_order,
+             internal::CoreOrder &&core_order)
+    : num_vertices_{neighbor_order.size()}, num_edges_{num_edges},
+      neighbor_order_{std::move(neighbor_order)},
+      core_order_{std::move(core_order)} {}
+
+void Index::Save(const std::string &path) const {
+    internal::WriteIndexFile(path, num_edges_, neighbor_order_, core_order_);
+}
+
+Index Index::Load(const std::string &path, const size_t num_vertices,
+                  const size_t num_edges) {
+    std::pair<internal::NeighborOrder, internal::CoreOrder> orders{
+        internal::ReadIndexFile(path, num_vertices, num_edges)};
+    return Index{num_edges, std::move(orders.first),
+                 std::move(orders.second)};
+}
 
 Clustering Index::Cluster(const uint64_t mu, const float epsilon,
                           const bool get_deterministic_result) const {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include "benchmarks/SCAN/IndexBased/scan_helpers.h"
 #include "benchmarks/SCAN/IndexBased/similarity_measure.h"
 #include "benchmarks/SCAN/IndexBased/utils.h"
@@ -33,11 +35,29 @@ class Index {
     explicit Index(
         symmetric_graph<VertexTemplate, Weight> *graph,
         const SimilarityMeasure &similarity_measure = scan::CosineSimilarity{})
-        : num_vertices_{graph->n}, neighbor_order_{graph, similarity_measure},
+        : num_vertices_{graph->n}, num_edges_{graph->m},
+          neighbor_order_{graph, similarity_measure},
           core_order_{neighbor_order_} {}
 
     Index();
 
+    // Writes the index to a binary file at `path`, which `Load` can map back
+    // into memory in another process without recomputing similarities.
+    void Save(const std::string &path) const;
+
+    // Loads an index of `graph` saved by `Save`. The file is memory-mapped
+    // rather than read, so loading takes time proportional to the number of
+    // vertices and the index data is paged in as clusterings touch it. The
+    // file must not be modified while the index is in use.
+    //
+    // Aborts if the index was saved for a graph with a different number of
+    // vertices or edges than `graph`.
+    template <template <typename> class VertexTemplate, typename Weight>
+    static Index Load(const std::string &path,
+                      symmetric_graph<VertexTemplate, Weight> *graph) {
+        return Load(path, graph->n, graph->m);
+    }
+
     // Compute a SCAN clustering of the indexed graph using SCAN parameters
     // mu and epsilon.
     //
@@ -81,7 +101,14 @@ class Index {
                  bool get_deterministic_result = false) const;
 
   private:
+    Index(size_t num_edges, internal::NeighborOrder &&neighbor_order,
+          internal::CoreOrder &&core_order);
+
+    static Index Load(const std::string &path, size_t num_vertices,
+                      size_t num_edges);
+
     size_t num_vertices_;
+    size_t num_edges_;
     internal::NeighborOrder neighbor_order_;
     internal::CoreOrder core_order_;
 };
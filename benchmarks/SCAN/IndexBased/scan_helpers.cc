@@ -1,7 +1,11 @@
 #include "benchmarks/SCAN/IndexBased/scan_helpers.h"
 
+#include <fstream>
 #include <limits>
 
+#include "gbbs/io.h"
+#include "pbbslib/assert.h"
+
 namespace gbbs {
 namespace indexed_scan {
 
@@ -13,10 +17,85 @@ struct VertexDegree {
     uintE degree;
 };
 
+// Index file layout: an `IndexFileHeader` followed by four arrays, each
+// starting at a multiple of `kIndexFileAlignment` bytes:
+//   uint64_t vertex_offsets[num_vertices + 1]
+//   EdgeSimilarity similarities[num_similarities]
+//   uint64_t mu_offsets[num_mu + 1]
+//   CoreThreshold thresholds[num_thresholds]
+// All fields are native-endian.
+struct IndexFileHeader {
+    uint64_t magic;
+    uint64_t num_vertices;
+    // Number of edges of the indexed graph, checked against the graph the
+    // index is loaded for.
+    uint64_t num_edges;
+    uint64_t num_similarities;
+    uint64_t num_mu;
+    uint64_t num_thresholds;
+    // sizeof(EdgeSimilarity) and sizeof(CoreThreshold) of the writer.
+    uint64_t edge_similarity_bytes;
+    uint64_t core_threshold_bytes;
+};
+
+// "SCANIDX2" in ASCII.
+constexpr uint64_t kIndexFileMagic{0x325844494e414353ULL};
+constexpr size_t kIndexFileAlignment{64};
+
+size_t AlignIndexFileOffset(const size_t offset) {
+    return (offset + kIndexFileAlignment - 1) / kIndexFileAlignment *
+           kIndexFileAlignment;
+}
+
+// Byte offsets of the four arrays in an index file, and the file size.
+struct IndexFileLayout {
+    size_t vertex_offsets;
+    size_t similarities;
+    size_t mu_offsets;
+    size_t thresholds;
+    size_t end;
+};
+
+IndexFileLayout GetIndexFileLayout(const IndexFileHeader &header) {
+    IndexFileLayout layout;
+    layout.vertex_offsets = AlignIndexFileOffset(sizeof(IndexFileHeader));
+    layout.similarities = AlignIndexFileOffset(
+        layout.vertex_offsets + (header.num_vertices + 1) * sizeof(uint64_t));
+    layout.mu_offsets = AlignIndexFileOffset(
+        layout.similarities +
+        header.num_similarities * sizeof(scan::EdgeSimilarity));
+    layout.thresholds = AlignIndexFileOffset(
+        layout.mu_offsets + (header.num_mu + 1) * sizeof(uint64_t));
+    layout.end = layout.thresholds +
+                 header.num_thresholds * sizeof(internal::CoreThreshold);
+    return layout;
+}
+
+// Writes `bytes` to `file` at byte offset `offset`, zero-padding from the
+// current end of the file.
+void WriteAt(std::ofstream *file, const size_t offset, const void *bytes,
+             const size_t num_bytes) {
+    const size_t position{static_cast<size_t>(file->tellp())};
+    for (size_t i = position; i < offset; i++) {
+        file->put(0);
+    }
+    file->write(static_cast<const char *>(bytes), num_bytes);
+}
+
 } // namespace
 
 namespace internal {
 
+MappedFile::MappedFile(const std::string &path) {
+    std::tie(data_, size_) = gbbs_io::mmapStringFromFile(path.c_str());
+}
+
+MappedFile::~MappedFile() { gbbs_io::unmmap(data_, size_); }
+
+const char *MappedFile::data() const { return data_; }
+
+size_t MappedFile::size() const { return size_; }
+
 std::ostream &operator<<(std::ostream &os,
                          const CoreThreshold &core_threshold) {
     os << "{vertex=" << core_threshold.vertex_id
@@ -32,6 +111,19 @@ void ReportTime([[maybe_unused]] const timer &t) {
 
 NeighborOrder::NeighborOrder() : similarities_{}, similarities_by_source_{} {}
 
+NeighborOrder::NeighborOrder(std::shared_ptr<const MappedFile> mapping,
+                             EdgeSimilarity *similarities,
+                             const uint64_t *vertex_offsets,
+                             const size_t num_vertices)
+    : similarities_{}, mapping_{std::move(mapping)} {
+    similarities_by_source_ = pbbs::sequence<pbbs::range<EdgeSimilarity *>>(
+        num_vertices, [&](const size_t i) {
+            return pbbs::range<EdgeSimilarity *>{
+                similarities + vertex_offsets[i],
+                similarities + vertex_offsets[i + 1]};
+        });
+}
+
 const pbbs::range<EdgeSimilarity *> &
 NeighborOrder::operator[](size_t source) const {
     return similarities_by_source_[source];
@@ -119,8 +211,42 @@ ComputeCoreOrder(const NeighborOrder &neighbor_order) {
 }
 
 CoreOrder::CoreOrder(const NeighborOrder &neighbor_order)
-    : num_vertices_{neighbor_order.size()}, order_{ComputeCoreOrder(
-                                                neighbor_order)} {}
+    : num_vertices_{neighbor_order.size()} {
+    const pbbs::sequence<pbbs::sequence<CoreThreshold>> core_order{
+        ComputeCoreOrder(neighbor_order)};
+    pbbs::sequence<size_t> offsets{
+        core_order.size(),
+        [&](const size_t i) { return core_order[i].size(); }};
+    const size_t num_thresholds{pbbslib::scan_add_inplace(offsets)};
+    thresholds_ = pbbs::sequence<CoreThreshold>::no_init(num_thresholds);
+    par_for(0, core_order.size(), [&](const size_t i) {
+        par_for(0, core_order[i].size(), [&](const size_t j) {
+            thresholds_[offsets[i] + j] = core_order[i][j];
+        });
+    });
+    order_ = pbbs::sequence<pbbs::range<CoreThreshold *>>{
+        core_order.size(), [&](const size_t i) {
+            return thresholds_.slice(offsets[i],
+                                     offsets[i] + core_order[i].size());
+        }};
+}
+
+CoreOrder::CoreOrder(std::shared_ptr<const MappedFile> mapping,
+                     const size_t num_vertices, CoreThreshold *thresholds,
+                     const uint64_t *mu_offsets, const size_t num_mu)
+    : num_vertices_{num_vertices}, mapping_{std::move(mapping)} {
+    order_ = pbbs::sequence<pbbs::range<CoreThreshold *>>(
+        num_mu, [&](const size_t i) {
+            return pbbs::range<CoreThreshold *>{thresholds + mu_offsets[i],
+                                                thresholds + mu_offsets[i + 1]};
+        });
+}
+
+size_t CoreOrder::num_vertices() const { return num_vertices_; }
+
+const pbbs::sequence<pbbs::range<CoreThreshold *>> &CoreOrder::order() const {
+    return order_;
+}
 
 pbbs::sequence<uintE> CoreOrder::GetCores(const uint64_t mu,
                                           const float epsilon) const {
@@ -132,7 +258,7 @@ pbbs::sequence<uintE> CoreOrder::GetCores(const uint64_t mu,
         return {};
     }
 
-    const pbbs::sequence<CoreThreshold> &possible_cores(order_[mu]);
+    const pbbs::range<CoreThreshold *> &possible_cores(order_[mu]);
     const size_t cores_end{pbbs::binary_search(
         possible_cores,
         [epsilon](const internal::CoreThreshold &core_threshold) {
@@ -144,6 +270,109 @@ pbbs::sequence<uintE> CoreOrder::GetCores(const uint64_t mu,
                             });
 }
 
+void WriteIndexFile(const std::string &path, const size_t num_edges,
+                    const NeighborOrder &neighbor_order,
+                    const CoreOrder &core_order) {
+    timer function_timer{"Write index file time"};
+    const size_t num_vertices{neighbor_order.size()};
+    // Every vertex's neighbor list is a slice of one contiguous array.
+    EdgeSimilarity *similarities{
+        num_vertices == 0 ? nullptr : neighbor_order[0].begin()};
+    const pbbs::sequence<uint64_t> vertex_offsets{
+        num_vertices + 1, [&](const size_t i) -> uint64_t {
+            return i == num_vertices
+                       ? (num_vertices == 0
+                              ? 0
+                              : neighbor_order[i - 1].end() - similarities)
+                       : neighbor_order[i].begin() - similarities;
+        }};
+    const auto &order{core_order.order()};
+    const size_t num_mu{order.size()};
+    CoreThreshold *thresholds{num_mu == 0 ? nullptr : order[0].begin()};
+    const pbbs::sequence<uint64_t> mu_offsets{
+        num_mu + 1, [&](const size_t i) -> uint64_t {
+            return i == num_mu ? (num_mu == 0 ? 0
+                                              : order[i - 1].end() - thresholds)
+                               : order[i].begin() - thresholds;
+        }};
+
+    const IndexFileHeader header{
+        .magic = kIndexFileMagic,
+        .num_vertices = num_vertices,
+        .num_edges = num_edges,
+        .num_similarities = vertex_offsets[num_vertices],
+        .num_mu = num_mu,
+        .num_thresholds = mu_offsets[num_mu],
+        .edge_similarity_bytes = sizeof(EdgeSimilarity),
+        .core_threshold_bytes = sizeof(CoreThreshold)};
+    const IndexFileLayout layout{GetIndexFileLayout(header)};
+
+    std::ofstream file{path, std::ios::out | std::ios::binary};
+    if (!file.is_open()) {
+        ABORT("Unable to open index file for writing: " << path);
+    }
+    WriteAt(&file, 0, &header, sizeof(header));
+    WriteAt(&file, layout.vertex_offsets, vertex_offsets.begin(),
+            vertex_offsets.size() * sizeof(uint64_t));
+    WriteAt(&file, layout.similarities, similarities,
+            header.num_similarities * sizeof(EdgeSimilarity));
+    WriteAt(&file, layout.mu_offsets, mu_offsets.begin(),
+            mu_offsets.size() * sizeof(uint64_t));
+    WriteAt(&file, layout.thresholds, thresholds,
+            header.num_thresholds * sizeof(CoreThreshold));
+    if (!file) {
+        ABORT("Failed to write index file: " << path);
+    }
+    internal::ReportTime(function_timer);
+}
+
+std::pair<NeighborOrder, CoreOrder> ReadIndexFile(const std::string &path,
+                                                  const size_t num_vertices,
+                                                  const size_t num_edges) {
+    timer function_timer{"Read index file time"};
+    auto mapping{std::make_shared<const MappedFile>(path)};
+    const char *bytes{mapping->data()};
+    if (mapping->size() < sizeof(IndexFileHeader)) {
+        ABORT("Index file is too small: " << path);
+    }
+    const IndexFileHeader &header{
+        *reinterpret_cast<const IndexFileHeader *>(bytes)};
+    if (header.magic != kIndexFileMagic ||
+        header.edge_similarity_bytes != sizeof(EdgeSimilarity) ||
+        header.core_threshold_bytes != sizeof(CoreThreshold)) {
+        ABORT("Not a SCAN index file (or written by an incompatible build): "
+              << path);
+    }
+    if (header.num_vertices != num_vertices || header.num_edges != num_edges) {
+        ABORT("Index file " << path << " is for a graph with "
+                            << header.num_vertices << " vertices and "
+                            << header.num_edges << " edges, not "
+                            << num_vertices << " vertices and " << num_edges
+                            << " edges");
+    }
+    const IndexFileLayout layout{GetIndexFileLayout(header)};
+    if (mapping->size() < layout.end) {
+        ABORT("Index file is truncated: " << path);
+    }
+
+    // The mapping is read-only; the index never writes through these
+    // pointers.
+    auto *similarities{reinterpret_cast<EdgeSimilarity *>(
+        const_cast<char *>(bytes + layout.similarities))};
+    auto *thresholds{reinterpret_cast<CoreThreshold *>(
+        const_cast<char *>(bytes + layout.thresholds))};
+    const auto *vertex_offsets{
+        reinterpret_cast<const uint64_t *>(bytes + layout.vertex_offsets)};
+    const auto *mu_offsets{
+        reinterpret_cast<const uint64_t *>(bytes + layout.mu_offsets)};
+    NeighborOrder neighbor_order{mapping, similarities, vertex_offsets,
+                                 header.num_vertices};
+    CoreOrder core_order{mapping, header.num_vertices, thresholds, mu_offsets,
+                         header.num_mu};
+    internal::ReportTime(function_timer);
+    return {std::move(neighbor_order), std::move(core_order)};
+}
+
 } // namespace internal
 
 } // namespace indexed_scan
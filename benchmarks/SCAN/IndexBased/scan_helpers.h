@@ -4,6 +4,8 @@
 // main SCAN header file.
 #pragma once
 
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "benchmarks/SCAN/IndexBased/similarity_measure.h"
@@ -19,6 +21,22 @@ namespace internal {
 
 using EdgeSimilarity = scan::EdgeSimilarity;
 
+// A read-only memory mapping of a whole file, unmapped on destruction.
+class MappedFile {
+  public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const;
+    size_t size() const;
+
+  private:
+    char *data_;
+    size_t size_;
+};
+
 // An adjacency list for the graph in which each vertex's neighbor list is
 // sorted by descending similarity.
 class NeighborOrder {
@@ -36,6 +54,14 @@ class NeighborOrder {
 
     NeighborOrder();
 
+    // Constructor for neighbor lists stored in a memory-mapped index file.
+    // `similarities` must point into `mapping`, sorted by source and then by
+    // descending similarity, and the neighbor list of vertex i is
+    // `similarities[vertex_offsets[i], vertex_offsets[i + 1])`.
+    NeighborOrder(std::shared_ptr<const MappedFile> mapping,
+                  EdgeSimilarity *similarities, const uint64_t *vertex_offsets,
+                  size_t num_vertices);
+
     // Get all similarity scores from vertex `source` to its neighbors (not
     // including `source` itself), sorted by descending similarity.
     const pbbs::range<EdgeSimilarity *> &operator[](size_t source) const;
@@ -52,6 +78,8 @@ class NeighborOrder {
     // similarity.
     pbbs::sequence<EdgeSimilarity> similarities_;
     pbbs::sequence<pbbs::range<EdgeSimilarity *>> similarities_by_source_;
+    // Set instead of `similarities_` when loaded from an index file.
+    std::shared_ptr<const MappedFile> mapping_;
 };
 
 struct CoreThreshold {
@@ -66,15 +94,46 @@ class CoreOrder {
   public:
     explicit CoreOrder(const NeighborOrder &neighbor_order);
 
+    // Constructor for a core order stored in a memory-mapped index file.
+    // `thresholds` must point into `mapping`, and the core order for mu == i
+    // is `thresholds[mu_offsets[i], mu_offsets[i + 1])` for i < `num_mu`.
+    CoreOrder(std::shared_ptr<const MappedFile> mapping, size_t num_vertices,
+              CoreThreshold *thresholds, const uint64_t *mu_offsets,
+              size_t num_mu);
+
     // Return all vertices that are cores under SCAN parameters `mu` and
     // `epsilon`.
     pbbs::sequence<uintE> GetCores(uint64_t mu, float epsilon) const;
 
+    size_t num_vertices() const;
+    // `order()[mu]` lists the vertices that can be cores when SCAN parameter
+    // mu is set to `mu`, sorted by descending core threshold (see
+    // `ComputeCoreOrder`).
+    const pbbs::sequence<pbbs::range<CoreThreshold *>> &order() const;
+
   private:
     size_t num_vertices_;
-    pbbs::sequence<pbbs::sequence<CoreThreshold>> order_{};
+    // The core orders for all values of mu, concatenated. Empty when loaded
+    // from an index file.
+    pbbs::sequence<CoreThreshold> thresholds_{};
+    pbbs::sequence<pbbs::range<CoreThreshold *>> order_{};
+    std::shared_ptr<const MappedFile> mapping_{};
 };
 
+// Writes `neighbor_order` and `core_order` of a graph with `num_edges` edges
+// to a binary index file at `path` that `ReadIndexFile` maps back into memory
+// without recomputing similarities.
+void WriteIndexFile(const std::string &path, size_t num_edges,
+                    const NeighborOrder &neighbor_order,
+                    const CoreOrder &core_order);
+
+// Memory-maps an index file written by `WriteIndexFile`. Aborts if the file
+// is not a valid index file or was written for a graph whose vertex or edge
+// count differs from `num_vertices` or `num_edges`.
+std::pair<NeighborOrder, CoreOrder> ReadIndexFile(const std::string &path,
+                                                  size_t num_vertices,
+                                                  size_t num_edges);
+
 // Prints the total time captured by `timer` to stderr if macro
 // SCAN_DETAILED_TIMES is defined, otherwise does nothing.
 void ReportTime(const timer &);
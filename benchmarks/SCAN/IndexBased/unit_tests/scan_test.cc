@@ -2,6 +2,7 @@
 #include "benchmarks/SCAN/IndexBased/scan_helpers.h"
 
 #include <math.h>
+#include <cstdio>
 #include <optional>
 #include <set>
 #include <string>
@@ -496,4 +497,87 @@ TEST(Cluster, TwoClusterGraph) {
                                  kExpectedOutliers);
     }
 }
+
+TEST(Index, SaveAndLoad) {
+    // Same graph as in the `Cluster.BasicUsage` test.
+    const size_t kNumVertices{6};
+    const std::unordered_set<UndirectedEdge> kEdges{
+        {0, 1}, {1, 2}, {1, 3}, {2, 3}, {2, 4}, {2, 5}, {3, 4},
+    };
+    auto graph{gt::MakeUnweightedSymmetricGraph(kNumVertices, kEdges)};
+    const std::string index_file{::testing::TempDir() + "scan_index_test"};
+    {
+        const i::Index index{&graph};
+        index.Save(index_file);
+    }
+    const i::Index index{i::Index::Load(index_file, &graph)};
+
+    {
+        constexpr uint64_t kMu{2};
+        constexpr float kEpsilon{0.73};
+        const i::Clustering clustering{index.Cluster(kMu, kEpsilon)};
+
+        const ClusterList kExpectedClusters{{1, 2, 3, 4}};
+        const VertexList kExpectedHubs{};
+        const VertexList kExpectedOutliers{0, 5};
+        EXPECT_TRUE(CheckClustering(clustering, kExpectedClusters));
+        CheckUnclusteredVertices(&graph, clustering, kExpectedHubs,
+                                 kExpectedOutliers);
+    }
+    {
+        constexpr uint64_t kMu{4};
+        constexpr float kEpsilon{0.7};
+        const i::Clustering clustering{index.Cluster(kMu, kEpsilon)};
+
+        const ClusterList kExpectedClusters{{1, 2, 3, 4}};
+        const VertexList kExpectedHubs{};
+        const VertexList kExpectedOutliers{0, 5};
+        EXPECT_TRUE(CheckClustering(clustering, kExpectedClusters));
+        CheckUnclusteredVertices(&graph, clustering, kExpectedHubs,
+                                 kExpectedOutliers);
+    }
+    std::remove(index_file.c_str());
+}
+
+TEST(Index, LoadForDifferentGraphAborts) {
+    const size_t kNumVertices{4};
+    auto graph{gt::MakeUnweightedSymmetricGraph(
+        kNumVertices, {{0, 1}, {1, 2}, {2, 3}})};
+    // Same number of vertices, one more edge.
+    auto other_graph{gt::MakeUnweightedSymmetricGraph(
+        kNumVertices, {{0, 1}, {1, 2}, {2, 3}, {3, 0}})};
+    const std::string index_file{::testing::TempDir() +
+                                 "scan_index_mismatch_test"};
+    {
+        const i::Index index{&graph};
+        index.Save(index_file);
+    }
+    EXPECT_DEATH(i::Index::Load(index_file, &other_graph), "is for a graph");
+    std::remove(index_file.c_str());
+}
+
+TEST(Index, SaveAndLoadEmptyGraph) {
+    const size_t kNumVertices{3};
+    const std::unordered_set<UndirectedEdge> kEdges{};
+    auto graph{gt::MakeUnweightedSymmetricGraph(kNumVertices, kEdges)};
+    const std::string index_file{::testing::TempDir() +
+                                 "scan_index_empty_test"};
+    {
+        const i::Index index{&graph};
+        index.Save(index_file);
+    }
+    const i::Index index{i::Index::Load(index_file, &graph)};
+
+    constexpr uint64_t kMu{2};
+    constexpr float kEpsilon{0.5};
+    const i::Clustering clustering{index.Cluster(kMu, kEpsilon)};
+
+    const ClusterList kExpectedClusters{};
+    const VertexList kExpectedHubs{};
+    const VertexList kExpectedOutliers{0, 1, 2};
+    EXPECT_TRUE(CheckClustering(clustering, kExpectedClusters));
+    CheckUnclusteredVertices(&graph, clustering, kExpectedHubs,
+                             kExpectedOutliers);
+    std::remove(index_file.c_str());
+}
 } // namespace gbbs
@@ -0,0 +1,64 @@
+// Usage:
+// numactl -i all ./BetweennessCentrality -s -m -rounds 3 twitter_SJ
+// flags:
+//   optional:
+//     -exact : compute exact scores, running Brandes from every vertex
+//     -eps : the additive error (relative to n(n-2)) of sampled scores
+//     -delta : the probability that some sampled score exceeds -eps
+//     -width : the number of sources processed per batch (at most 64)
+//     -seed : the seed used to sample sources
+//     -rounds : the number of times to run the algorithm
+//     -c : indicate that the graph is compressed
+//     -m : indicate that the graph should be mmap'd
+//     -s : indicate that the graph is symmetric
+
+#include "BetweennessCentrality.h"
+
+namespace gbbs {
+
+template <class Graph>
+double BetweennessCentrality_runner(Graph &G, commandLine P) {
+    bool exact = P.getOptionValue("-exact");
+    double eps = P.getOptionDoubleValue("-eps", 0.01);
+    double delta = P.getOptionDoubleValue("-delta", 0.1);
+    size_t width = P.getOptionLongValue("-width", 64);
+    size_t seed = P.getOptionLongValue("-seed", 0);
+    if (width < 1 || width > 64) {
+        std::cout << "usage: " << P.argv[0]
+                  << " [-exact] [-eps <eps>] [-delta <delta>] [-width <1-64>]"
+                     " [-seed <seed>] [-s] <inFile>"
+                  << std::endl;
+        exit(1);
+    }
+    std::cout << "### Application: BetweennessCentrality" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -exact = " << exact << " -eps = " << eps
+              << " -delta = " << delta << " -width = " << width << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+
+    timer t;
+    t.start();
+    auto result =
+        exact ? global_bc::BetweennessCentrality(G, width)
+              : global_bc::ApproximateBetweennessCentrality(G, eps, delta,
+                                                            width, seed);
+    double tt = t.stop();
+
+    auto max_score = pbbslib::reduce_max(result.scores);
+    std::cout << "# sources = " << result.num_sources
+              << " epsilon = " << result.epsilon
+              << " max score = " << max_score << std::endl;
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+#ifdef ACCESS_OBSERVER
+    struct observer access_observer("betweenness_centrality.txt");
+#endif
+
+} // namespace gbbs
+
+generate_main(gbbs::BetweennessCentrality_runner, false);
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "benchmarks/BFS/MultiSourceBFS/MultiSourceBFS.h"
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+namespace global_bc {
+
+using fType = double;
+using bits = msbfs::bits64;
+
+// Brandes' algorithm for a batch of up to 64 sources at once. The forward
+// phase is a single multi-source BFS, so each level's edge traversal is shared
+// by the whole batch; path counts are then pulled from the predecessors of the
+// vertices reached in that level. The backward phase walks the levels in
+// reverse, pulling dependencies from successors.
+//
+// Per-source state is stored vertex-major (the width entries of a vertex are
+// contiguous), so a scan of a neighbor list touches one cache line per
+// neighbor for the whole batch. The workspace is allocated once and only the
+// entries of reached vertices are reset between batches.
+template <class Graph> struct batch_brandes {
+    using W = typename Graph::weight_type;
+    static constexpr uint32_t kUnreached = UINT32_MAX;
+
+    Graph &G;
+    size_t n;
+    size_t width;
+    sequence<uint32_t> dist;
+    sequence<fType> sigma;
+    sequence<fType> delta;
+    std::vector<sequence<uintE>> levels;
+
+    batch_brandes(Graph &G, size_t width)
+        : G(G), n(G.n), width(width) {
+        assert(width <= bits::kNumSources);
+        dist = sequence<uint32_t>(n * width, kUnreached);
+        sigma = sequence<fType>(n * width, (fType)0);
+        delta = sequence<fType>(n * width, (fType)0);
+    }
+
+    // Sources of the batch reaching v at distance level.
+    inline bits at_level(uintE v, uint32_t level, size_t k) const {
+        bits b;
+        const uint32_t *d = dist.begin() + v * width;
+        for (size_t j = 0; j < k; j++) {
+            if (d[j] == level)
+                b.set(j);
+        }
+        return b;
+    }
+
+    // Adds the dependency delta_s(v) of every source s in sources to sum[v],
+    // and its square to sum_sq[v].
+    void run(const sequence<uintE> &sources, sequence<fType> &sum,
+             sequence<fType> &sum_sq) {
+        size_t k = sources.size();
+        auto visit_f = [&](const uintE &v, size_t level, const bits &b) {
+            b.for_each([&](size_t j) {
+                dist[v * width + j] = level;
+                if (level == 0)
+                    sigma[v * width + j] = 1;
+            });
+        };
+        auto level_f = [&](size_t level, vertexSubset &vs) {
+            vs.toSparse();
+            auto L = sequence<uintE>(vs.size(), [&](size_t i) { return vs.vtx(i); });
+            if (level > 0) {
+                parallel_for(
+                    0, L.size(),
+                    [&](size_t i) {
+                        uintE v = L[i];
+                        bits mask = at_level(v, level, k);
+                        fType *sv = sigma.begin() + v * width;
+                        auto map_f = [&](const uintE &v_, const uintE &u,
+                                         const W &wgh) {
+                            const uint32_t *du = dist.begin() + u * width;
+                            const fType *su = sigma.begin() + u * width;
+                            mask.for_each([&](size_t j) {
+                                if (du[j] + 1 == level)
+                                    sv[j] += su[j];
+                            });
+                        };
+                        G.get_vertex(v).in_neighbors().map(map_f, false);
+                    },
+                    1);
+            }
+            levels.push_back(std::move(L));
+        };
+        msbfs::MultiSourceBFS<bits>(G, sources, visit_f, level_f);
+
+        for (long level = (long)levels.size() - 1; level > 0; level--) {
+            auto &L = levels[level];
+            parallel_for(
+                0, L.size(),
+                [&](size_t i) {
+                    uintE u = L[i];
+                    bits mask = at_level(u, level, k);
+                    fType acc[bits::kNumSources];
+                    const fType *su = sigma.begin() + u * width;
+                    mask.for_each([&](size_t j) { acc[j] = 0; });
+                    auto map_f = [&](const uintE &u_, const uintE &v,
+                                     const W &wgh) {
+                        const uint32_t *dv = dist.begin() + v * width;
+                        const fType *sv = sigma.begin() + v * width;
+                        const fType *ev = delta.begin() + v * width;
+                        mask.for_each([&](size_t j) {
+                            if (dv[j] == level + 1)
+                                acc[j] += (su[j] / sv[j]) * (1 + ev[j]);
+                        });
+                    };
+                    G.get_vertex(u).out_neighbors().map(map_f, false);
+                    fType *eu = delta.begin() + u * width;
+                    mask.for_each([&](size_t j) {
+                        eu[j] = acc[j];
+                        sum[u] += acc[j];
+                        sum_sq[u] += acc[j] * acc[j];
+                    });
+                },
+                1);
+        }
+
+        for (auto &L : levels) {
+            parallel_for(0, L.size(), [&](size_t i) {
+                size_t o = L[i] * width;
+                for (size_t j = 0; j < width; j++) {
+                    dist[o + j] = kUnreached;
+                    sigma[o + j] = 0;
+                    delta[o + j] = 0;
+                }
+            });
+        }
+        levels.clear();
+    }
+};
+
+struct bc_result {
+    sequence<fType> scores;
+    size_t num_sources;
+    // For sampled runs, the bound (holding with the requested probability) on
+    // the error of every score divided by n(n-2); 0 for exact runs.
+    double epsilon;
+};
+
+// Exact betweenness centrality: the sum over every source s of delta_s(v).
+// On symmetric graphs each unordered pair is counted twice, as in Brandes'
+// algorithm.
+template <class Graph>
+inline bc_result BetweennessCentrality(Graph &G, size_t width = 64) {
+    size_t n = G.n;
+    auto sum = sequence<fType>(n, (fType)0);
+    auto sum_sq = sequence<fType>(n, (fType)0);
+    batch_brandes<Graph> B(G, width);
+    for (size_t start = 0; start < n; start += width) {
+        size_t end = std::min(start + width, n);
+        auto sources = sequence<uintE>(end - start,
+                                       [&](size_t i) { return start + i; });
+        B.run(sources, sum, sum_sq);
+    }
+    return bc_result{std::move(sum), n, 0.0};
+}
+
+// Estimates betweenness centrality from sources sampled uniformly at random,
+// scaling the summed dependencies by n / k. With x_s(v) = delta_s(v) / (n-2)
+// in [0, 1], the returned scores divided by n(n-2) are within epsilon of the
+// exact ones for every vertex with probability at least 1 - failure_prob.
+//
+// Half of failure_prob pays for a Hoeffding bound, which caps the number of
+// samples at ln(4n / failure_prob) / (2 epsilon^2). The other half is split
+// over the stopping checks made after every batch (failure_prob / 2^(i+2) for
+// the i-th check, union-bounded over the vertices); a check stops sampling
+// once the empirical Bernstein bound of every vertex is below epsilon, which
+// for the low-variance scores of most vertices happens well before the cap.
+template <class Graph>
+inline bc_result ApproximateBetweennessCentrality(Graph &G, double epsilon,
+                                                  double failure_prob,
+                                                  size_t width = 64,
+                                                  size_t seed = 0) {
+    size_t n = G.n;
+    auto sum = sequence<fType>(n, (fType)0);
+    auto sum_sq = sequence<fType>(n, (fType)0);
+    if (n <= 2) {
+        return bc_result{std::move(sum), 0, 0.0};
+    }
+    double range = n - 2;
+    size_t max_samples = (size_t)std::ceil(
+        std::log(4.0 * n / failure_prob) / (2 * epsilon * epsilon));
+    double achieved = epsilon;
+
+    batch_brandes<Graph> B(G, width);
+    auto r = pbbslib::random(seed);
+    size_t k = 0;
+    for (size_t check = 0; k < max_samples; check++) {
+        size_t batch = std::min(width, max_samples - k);
+        auto sources = sequence<uintE>(
+            batch, [&](size_t i) { return r.ith_rand(k + i) % n; });
+        B.run(sources, sum, sum_sq);
+        k += batch;
+        if (k < 2 || k >= max_samples)
+            continue;
+
+        double log_term = std::log(3.0 * n / std::ldexp(failure_prob, -(int)check - 2));
+        auto bound = pbbslib::make_sequence<double>(n, [&](size_t v) {
+            double mean = sum[v] / range / k;
+            double var = (sum_sq[v] / (range * range) - k * mean * mean) / (k - 1);
+            var = std::max(var, 0.0);
+            return std::sqrt(2 * var * log_term / k) + 3 * log_term / (k - 1);
+        });
+        double worst = pbbslib::reduce_max(bound);
+        debug(std::cout << "# samples = " << k << " bound = " << worst
+                        << std::endl;);
+        if (worst <= epsilon) {
+            achieved = worst;
+            break;
+        }
+    }
+    double scale = (double)n / k;
+    parallel_for(0, n, [&](size_t v) { sum[v] *= scale; });
+    return bc_result{std::move(sum), k, achieved};
+}
+
+} // namespace global_bc
+} // namespace gbbs
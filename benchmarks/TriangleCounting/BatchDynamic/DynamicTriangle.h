@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "gbbs/dynamic_batch.h"
+#include "gbbs/gbbs.h"
+
+namespace gbbs {
+namespace dynamic_triangle {
+
+using edge = dynamic_batch::edge;
+
+// Exact global and per-vertex triangle counts of an undirected graph under
+// batches of edge insertions and deletions.
+//
+// The triangles created (or destroyed) by a batch are exactly the triangles
+// of the graph with the batch inserted (or not yet deleted) that contain at
+// least one edge of the batch. Each of them is found by intersecting the
+// neighbor lists of the endpoints of its batch edges, and is credited only by
+// the smallest of them, so a triangle with two or three batch edges is
+// counted once. A batch thus takes O(sum over its edges (u, v) of
+// min(deg(u), deg(v)) log(max(deg(u), deg(v)))) work, independent of the
+// size of the rest of the graph, and the counts of a vertex only change if
+// it is in a triangle that contains a batch edge.
+//
+// The graph is kept as sorted adjacency vectors.
+struct DynamicTriangle : dynamic_batch::adjacency_graph {
+    size_t total;            // number of triangles
+    sequence<size_t> counts; // number of triangles containing each vertex
+
+    // Starts from the subgraph of G containing the edges (u, v) for which
+    // keep(u, v) is true; keep must be symmetric.
+    template <class Graph, class Keep>
+    DynamicTriangle(Graph &G, Keep keep)
+        : dynamic_batch::adjacency_graph(G, keep) {
+        counts = StaticCounts();
+        total = pbbslib::reduce_add(counts) / 3;
+    }
+
+    // Per-vertex triangle counts of the current graph from scratch. Edges
+    // are directed from lower to higher (degree, id), as in
+    // Triangle_degree_ordering, and every directed triangle is found once.
+    sequence<size_t> StaticCounts() const {
+        auto lower = [&](uintE u, uintE v) {
+            return adj[u].size() < adj[v].size() ||
+                   (adj[u].size() == adj[v].size() && u < v);
+        };
+        auto out = std::vector<std::vector<uintE>>(n);
+        parallel_for(
+            0, n,
+            [&](size_t u) {
+                for (uintE v : adj[u]) {
+                    if (lower(u, v)) {
+                        out[u].push_back(v);
+                    }
+                }
+            },
+            1);
+        auto ct = sequence<size_t>(n, (size_t)0);
+        parallel_for(
+            0, n,
+            [&](size_t u) {
+                for (uintE v : out[u]) {
+                    size_t found = merge_intersect(
+                        out[u], out[v], [&](uintE w) {
+                            pbbslib::write_add(&ct[v], 1);
+                            pbbslib::write_add(&ct[w], 1);
+                        });
+                    pbbslib::write_add(&ct[u], found);
+                }
+            },
+            1);
+        return ct;
+    }
+
+    void InsertEdges(const sequence<edge> &batch) {
+        auto E = normalize(batch, false);
+        if (E.size() == 0) {
+            return;
+        }
+        auto both = dynamic_batch::directed(E);
+        add_edges(both);
+        total += credit(E, both, 1);
+    }
+
+    void DeleteEdges(const sequence<edge> &batch) {
+        auto E = normalize(batch, true);
+        if (E.size() == 0) {
+            return;
+        }
+        auto both = dynamic_batch::directed(E);
+        total -= credit(E, both, -1);
+        remove_edges(both);
+    }
+
+  private:
+    // Finds the triangles of the current graph that contain an edge of E
+    // (sorted, with both orientations in both), adds sign to the counts of
+    // their vertices, and returns their number.
+    size_t credit(const sequence<edge> &E, const sequence<edge> &both,
+                  int sign) {
+        auto in_batch = [&](uintE a, uintE b) {
+            return std::binary_search(both.begin(), both.end(), edge(a, b));
+        };
+        auto found = sequence<size_t>(E.size());
+        parallel_for(
+            0, E.size(),
+            [&](size_t i) {
+                uintE u = E[i].first, v = E[i].second;
+                size_t ct = 0;
+                auto f = [&](uintE w) {
+                    // Only the smallest batch edge of the triangle credits
+                    // it.
+                    edge uw = (u < w) ? edge(u, w) : edge(w, u);
+                    edge vw = (v < w) ? edge(v, w) : edge(w, v);
+                    if ((uw < E[i] && in_batch(u, w)) ||
+                        (vw < E[i] && in_batch(v, w))) {
+                        return;
+                    }
+                    pbbslib::write_add(&counts[w], (size_t)sign);
+                    ct++;
+                };
+                intersect(adj[u], adj[v], f);
+                pbbslib::write_add(&counts[u], (size_t)sign * ct);
+                pbbslib::write_add(&counts[v], (size_t)sign * ct);
+                found[i] = ct;
+            },
+            1);
+        return pbbslib::reduce_add(found);
+    }
+
+    // Calls f(w) for every w in both (sorted) lists. Merges the two lists, or
+    // binary searches the longer list for each element of the shorter one
+    // when their lengths differ by more than kSearchRatio.
+    static constexpr size_t kSearchRatio = 32;
+    template <class F>
+    static size_t intersect(const std::vector<uintE> &A,
+                            const std::vector<uintE> &B, F f) {
+        if (A.size() > B.size()) {
+            return intersect(B, A, f);
+        }
+        if (A.size() * kSearchRatio >= B.size()) {
+            return merge_intersect(A, B, f);
+        }
+        size_t ct = 0;
+        for (uintE w : A) {
+            if (std::binary_search(B.begin(), B.end(), w)) {
+                f(w);
+                ct++;
+            }
+        }
+        return ct;
+    }
+
+    template <class F>
+    static size_t merge_intersect(const std::vector<uintE> &A,
+                                  const std::vector<uintE> &B, F f) {
+        size_t i = 0, j = 0, ct = 0;
+        while (i < A.size() && j < B.size()) {
+            if (A[i] == B[j]) {
+                f(A[i]);
+                i++, j++, ct++;
+            } else if (A[i] < B[j]) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+        return ct;
+    }
+};
+
+} // namespace dynamic_triangle
+} // namespace gbbs
@@ -0,0 +1,102 @@
+// Usage:
+// numactl -i all ./ApproximateTriangle -s -method wedge -samples 100000 <graph>
+// flags:
+//   required:
+//     -s : indicates that the graph is symmetric
+//   optional:
+//     -m : indicate that the graph should be mmap'd
+//     -c : indicate that the graph is compressed
+//     -rounds : the number of times to run the algorithm
+//     -method : doulion, colorful or wedge (default doulion)
+//     -p : the fraction of the edges kept by doulion and colorful (default
+//          0.1); colorful uses round(1 / p) colors. Smaller is faster and less
+//          accurate.
+//     -samples : the number of wedges sampled per trial by wedge (default
+//                1000000)
+//     -trials : the number of independent trials (default 4). doulion and
+//               colorful need at least 2, since their interval comes from the
+//               sample variance of the trials.
+//     -confidence : the confidence level of the reported interval (default
+//                   0.95)
+//     -exact : also count the triangles exactly and report the relative error
+
+#include "ApproximateTriangle.h"
+
+namespace gbbs {
+
+template <class W>
+approx_triangle::estimate run_wedge(symmetric_graph<symmetric_vertex, W> &G,
+                                    size_t samples, size_t trials,
+                                    double confidence) {
+    return approx_triangle::WedgeSampling(G, samples, trials, confidence);
+}
+template <class Graph>
+approx_triangle::estimate run_wedge(Graph &G, size_t samples, size_t trials,
+                                    double confidence) {
+    std::cout << "-method wedge requires an uncompressed graph" << std::endl;
+    exit(-1);
+}
+
+template <class Graph>
+double ApproximateTriangle_runner(Graph &G, commandLine P) {
+    auto method = P.getOptionValue("-method", "doulion");
+    double p = P.getOptionDoubleValue("-p", 0.1);
+    size_t samples = P.getOptionLongValue("-samples", 1000000);
+    size_t trials = P.getOptionLongValue("-trials", 4);
+    double confidence = P.getOptionDoubleValue("-confidence", 0.95);
+    std::cout << "### Application: ApproximateTriangle" << std::endl;
+    std::cout << "### Graph: " << P.getArgument(0) << std::endl;
+    std::cout << "### Threads: " << num_workers() << std::endl;
+    std::cout << "### n: " << G.n << std::endl;
+    std::cout << "### m: " << G.m << std::endl;
+    std::cout << "### Params: -method = " << method << " -p = " << p
+              << " -samples = " << samples << " -trials = " << trials
+              << " -confidence = " << confidence << std::endl;
+    std::cout << "### ------------------------------------" << std::endl;
+    assert(P.getOption("-s"));
+    if (trials == 0 || p <= 0 || p > 1) {
+        std::cout << "-trials must be positive and -p in (0, 1]" << std::endl;
+        exit(-1);
+    }
+    if ((method == "doulion" || method == "colorful") && trials < 2) {
+        std::cout << "-method " << method << " requires -trials >= 2"
+                  << std::endl;
+        exit(-1);
+    }
+
+    timer t;
+    t.start();
+    approx_triangle::estimate est;
+    if (method == "doulion") {
+        est = approx_triangle::Doulion(G, p, trials, confidence);
+    } else if (method == "colorful") {
+        size_t num_colors = std::max((size_t)1, (size_t)round(1 / p));
+        est = approx_triangle::Colorful(G, num_colors, trials, confidence);
+    } else if (method == "wedge") {
+        est = run_wedge(G, samples, trials, confidence);
+    } else {
+        std::cerr << "Unexpected method: " << method << '\n';
+        exit(1);
+    }
+    double tt = t.stop();
+
+    std::cout << "### Estimated triangles = " << (size_t)est.count << "\n";
+    std::cout << "### Standard error = " << est.std_error << "\n";
+    std::cout << "### " << confidence * 100 << "% interval = ["
+              << (size_t)est.lo << ", " << (size_t)est.hi << "]\n";
+    if (P.getOption("-exact")) {
+        auto f = [&](uintE u, uintE v, uintE w) {};
+        size_t exact = Triangle_degree_ordering(G, f);
+        double error =
+            fabs(est.count - (double)exact) / std::max(exact, (size_t)1);
+        std::cout << "### Relative error = " << error
+                  << " (in interval: " << (est.lo <= exact && exact <= est.hi)
+                  << ")\n";
+    }
+    std::cout << "### Running Time: " << tt << std::endl;
+    return tt;
+}
+
+} // namespace gbbs
+
+generate_symmetric_main(gbbs::ApproximateTriangle_runner, false);
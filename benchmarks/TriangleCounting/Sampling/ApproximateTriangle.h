@@ -0,0 +1,222 @@
+#pragma once
+
+#include <math.h>
+#include <vector>
+
+#include "benchmarks/TriangleCounting/ShunTangwongsan15/Triangle.h"
+#include "gbbs/gbbs.h"
+#include "pbbslib/random.h"
+
+namespace gbbs {
+namespace approx_triangle {
+
+// An estimate of the number of triangles with a two-sided confidence
+// interval [lo, hi] at the requested confidence level.
+struct estimate {
+    double count;
+    double std_error;
+    double lo;
+    double hi;
+    size_t trials;
+};
+
+// P(|T| < t) for a Student t variable T with df degrees of freedom, using the
+// closed forms for integer df; df = 0 stands for the standard normal.
+inline double two_sided_probability(double t, size_t df) {
+    if (df == 0) {
+        return erf(t / sqrt(2.0));
+    }
+    double theta = atan(t / sqrt((double)df));
+    double c2 = cos(theta) * cos(theta);
+    double term = 1, sum = 1;
+    if (df % 2 == 1) {
+        for (size_t k = 3; k + 2 <= df; k += 2) {
+            term *= c2 * (k - 1) / k;
+            sum += term;
+        }
+        double a = theta + ((df > 1) ? sin(theta) * cos(theta) * sum : 0);
+        return 2 * a / M_PI;
+    }
+    for (size_t k = 2; k + 2 <= df; k += 2) {
+        term *= c2 * (k - 1) / k;
+        sum += term;
+    }
+    return sin(theta) * sum;
+}
+
+// The z such that a Student t variable with df degrees of freedom (or a
+// standard normal one, if df = 0) lies in [-z, z] with the given
+// probability, by bisection.
+inline double quantile(double confidence, size_t df = 0) {
+    double lo = 0, hi = 1e6;
+    for (size_t i = 0; i < 200; i++) {
+        double mid = (lo + hi) / 2;
+        if (two_sided_probability(mid, df) < confidence) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo + hi) / 2;
+}
+
+inline estimate with_interval(double count, double std_error, size_t trials,
+                              double confidence, size_t df = 0) {
+    double z = quantile(confidence, df);
+    return estimate{count, std_error, std::max(0.0, count - z * std_error),
+                    count + z * std_error, trials};
+}
+
+// The mean of at least two independent unbiased estimates, with the standard
+// error of the mean taken from their sample variance. The interval uses the t
+// distribution, since there are usually only a few trials.
+inline estimate summarize(const std::vector<double> &x, double confidence) {
+    assert(x.size() >= 2);
+    double mean = 0;
+    for (double v : x)
+        mean += v;
+    mean /= x.size();
+    double var = 0;
+    for (double v : x)
+        var += (v - mean) * (v - mean);
+    double std_error = sqrt(var / (x.size() - 1) / x.size());
+    return with_interval(mean, std_error, x.size(), confidence,
+                         x.size() - 1);
+}
+
+// The number of triangles in the subgraph of G with the edges (u, v) for
+// which keep(u, v) is true (keep must be symmetric). The subgraph is built
+// already directed by rank, as in Triangle_degree_ordering.
+template <class Graph, class Keep>
+inline size_t CountSubgraph(Graph &G, const uintE *rank, Keep keep) {
+    using W = typename Graph::weight_type;
+    auto pack_predicate = [&](const uintE &u, const uintE &v, const W &wgh) {
+        return rank[u] < rank[v] && keep(u, v);
+    };
+    auto DG = filterGraph(G, pack_predicate);
+    auto counts = sequence<size_t>(G.n, (size_t)0);
+    auto f = [&](uintE u, uintE v, uintE w) {};
+    size_t count = CountDirectedBalanced(DG, counts.begin(), f);
+    DG.del();
+    return count;
+}
+
+inline size_t edge_hash(uintE u, uintE v, size_t seed) {
+    size_t key = (static_cast<size_t>(std::min(u, v)) << 32UL) +
+                 static_cast<size_t>(std::max(u, v));
+    return pbbs::hash64(pbbs::hash64(key) ^ pbbs::hash64(seed));
+}
+
+// DOULION (Tsourakakis et al.): keeps every edge independently with
+// probability p and scales the exact count of the sampled graph by 1 / p^3.
+// The sampled graph has about p * m edges, so smaller p trades accuracy for
+// time.
+template <class Graph>
+inline estimate Doulion(Graph &G, double p, size_t trials, double confidence,
+                        size_t seed = 0) {
+    uintE *rank = rankNodes(G, G.n);
+    std::vector<double> x;
+    for (size_t t = 0; t < trials; t++) {
+        // The hash is mapped to a double in [0, 1] and compared with p, since
+        // p * SIZE_MAX is not representable as a size_t when p = 1.
+        auto keep = [&](uintE u, uintE v) {
+            return p >= 1 ||
+                   static_cast<double>(edge_hash(u, v, seed + t)) /
+                           static_cast<double>(
+                               std::numeric_limits<size_t>::max()) <
+                       p;
+        };
+        x.push_back(CountSubgraph(G, rank, keep) / (p * p * p));
+    }
+    pbbslib::free_array(rank);
+    return summarize(x, confidence);
+}
+
+// Colorful sparsification (Pagh and Tsourakakis): colors the vertices with
+// num_colors colors at random and keeps the monochromatic edges. A triangle
+// survives with probability 1 / num_colors^2, so the count of the sampled
+// graph is scaled by num_colors^2. It keeps about m / num_colors edges, like
+// DOULION with p = 1 / num_colors, but with less variance on graphs whose
+// triangles share few edges.
+template <class Graph>
+inline estimate Colorful(Graph &G, size_t num_colors, size_t trials,
+                         double confidence, size_t seed = 0) {
+    uintE *rank = rankNodes(G, G.n);
+    std::vector<double> x;
+    auto colors = sequence<uintE>(G.n);
+    for (size_t t = 0; t < trials; t++) {
+        auto r = pbbs::random(seed).fork(t);
+        parallel_for(0, G.n,
+                     [&](size_t i) { colors[i] = r.ith_rand(i) % num_colors; });
+        auto keep = [&](uintE u, uintE v) { return colors[u] == colors[v]; };
+        x.push_back(CountSubgraph(G, rank, keep) *
+                    (double)(num_colors * num_colors));
+    }
+    pbbslib::free_array(rank);
+    return summarize(x, confidence);
+}
+
+// Wedge sampling (Seshadhri et al.): samples wedges (paths of length two)
+// uniformly at random, by picking the center with probability proportional
+// to its number of wedges and then two distinct neighbors, and checks if
+// they are closed. Every triangle closes three wedges, so the estimate is
+// (closed fraction) * (number of wedges) / 3, with a binomial standard error
+// over all sampled wedges. The work is O(n + samples log n), independent of
+// the number of triangles; closing a wedge uses a binary search, so the graph
+// must be uncompressed.
+template <class W>
+inline estimate WedgeSampling(symmetric_graph<symmetric_vertex, W> &G,
+                              size_t samples, size_t trials, double confidence,
+                              size_t seed = 0) {
+    size_t n = G.n;
+    auto neighbor = [&](uintE u, uintE i) {
+        return std::get<0>(G.e0[G.v_data[u].offset + i]);
+    };
+    auto adjacent = [&](uintE u, uintE v) {
+        auto nghs = G.e0 + G.v_data[u].offset;
+        auto end = nghs + G.v_data[u].degree;
+        auto it = std::lower_bound(
+            nghs, end, v, [](const std::tuple<uintE, W> &a, uintE b) {
+                return std::get<0>(a) < b;
+            });
+        return it != end && std::get<0>(*it) == v;
+    };
+    auto wedges = sequence<size_t>(n, [&](size_t i) {
+        size_t deg = G.v_data[i].degree;
+        return deg * (deg - (deg > 0)) / 2;
+    });
+    size_t total_wedges = pbbslib::scan_add_inplace(wedges.slice());
+    if (total_wedges == 0) {
+        return with_interval(0, 0, trials, confidence);
+    }
+    size_t total = samples * trials;
+    pbbs::random r(seed);
+    auto closed = pbbs::delayed_seq<size_t>(total, [&](size_t i) {
+        // Hashes of consecutive keys are correlated enough to bias the
+        // estimate, so the three random numbers are chained hashes.
+        size_t h0 = r.ith_rand(i);
+        size_t h1 = pbbs::hash64(h0);
+        size_t h2 = pbbs::hash64(h1);
+        size_t x = h0 % total_wedges;
+        // The center is the last vertex whose wedge offset is at most x.
+        size_t c =
+            pbbslib::binary_search(wedges, x + 1, std::less<size_t>()) - 1;
+        uintE deg = G.v_data[c].degree;
+        uintE a = h1 % deg;
+        uintE b = h2 % (deg - 1);
+        b += (b >= a);
+        uintE u = neighbor(c, a);
+        uintE v = neighbor(c, b);
+        if (G.v_data[u].degree > G.v_data[v].degree) {
+            std::swap(u, v);
+        }
+        return (size_t)adjacent(u, v);
+    });
+    double f = (double)pbbslib::reduce_add(closed) / total;
+    double scale = (double)total_wedges / 3;
+    return with_interval(f * scale, scale * sqrt(f * (1 - f) / total), trials,
+                         confidence);
+}
+
+} // namespace approx_triangle
+} // namespace gbbs
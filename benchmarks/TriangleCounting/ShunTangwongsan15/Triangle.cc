@@ -30,26 +30,61 @@
 //     -m : indicate that the graph should be mmap'd
 //     -c : indicate that the graph is compressed
 //     -rounds : the number of times to run the algorithm
+//     -local : compute the support of every edge, the triangle count of
+//              every vertex and the local clustering coefficients instead of
+//              only the global count (uncompressed graphs only)
 
 #include "Triangle.h"
 
 namespace gbbs {
 
+template <class W>
+size_t run_local(symmetric_graph<symmetric_vertex, W> &G) {
+    timer t;
+    t.start();
+    auto ids = make_edge_ids(G);
+    t.next("edge ids time");
+    auto support = TriangleEdgeSupport(G, ids);
+    t.next("edge support time");
+    auto counts = TriangleVertexCounts(G, ids, support);
+    auto lcc = LocalClusteringCoefficient(G, counts);
+    t.next("vertex counts time");
+    size_t count = pbbslib::reduce_add(counts) / 3;
+    std::cout << "### Num triangles = " << count << "\n";
+    std::cout << "### Max edge support = "
+              << pbbslib::reduce_max(support) << "\n";
+    std::cout << "### Max vertex count = " << pbbslib::reduce_max(counts)
+              << "\n";
+    std::cout << "### Average local clustering coefficient = "
+              << pbbslib::reduce_add(lcc) / G.n << "\n";
+    return count;
+}
+template <class Graph> size_t run_local(Graph &G) {
+    std::cout << "-local requires an uncompressed graph" << std::endl;
+    exit(-1);
+}
+
 template <class Graph> double Triangle_runner(Graph &G, commandLine P) {
     auto ordering = P.getOptionValue("-ordering", "degree");
+    bool local = P.getOption("-local");
     std::cout << "### Application: Triangle Counting" << std::endl;
     std::cout << "### Graph: " << P.getArgument(0) << std::endl;
     std::cout << "### Threads: " << num_workers() << std::endl;
     std::cout << "### n: " << G.n << std::endl;
     std::cout << "### m: " << G.m << std::endl;
-    std::cout << "### Params: ordering=" << ordering << std::endl;
+    std::cout << "### Params: ordering=" << ordering << " -local = " << local
+              << std::endl;
     std::cout << "### ------------------------------------" << std::endl;
     assert(P.getOption("-s"));
     size_t count = 0;
     auto f = [&](uintE u, uintE v, uintE w) {};
     timer t;
     t.start();
-    count = Triangle(G, f, ordering, P);
+    if (local) {
+        count = run_local(G);
+    } else {
+        count = Triangle(G, f, ordering, P);
+    }
     double tt = t.stop();
     if (P.getOption("-stats")) {
         auto wedge_im_f = [&](size_t i) {
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 
+#include "gbbs/edge_ids.h"
 #include "gbbs/gbbs.h"
 #include "pbbslib/monoid.h"
 #include "pbbslib/sample_sort.h"
@@ -247,6 +248,68 @@ inline size_t Triangle_degeneracy_ordering(Graph &G, const F &f,
     return count;
 }
 
+// Local triangle statistics. Counting triangles on the directed graph finds
+// each triangle once, at its lowest-ranked vertex, so per-vertex or per-edge
+// counts from the callback of Triangle need atomic increments on the other
+// two vertices (or edges), which contend on hubs. Instead, the functions below
+// give every output a single writer: the support of an edge {u, v} is the
+// size of the intersection of the neighbor lists of u and v, computed by the
+// task owning the edge, and the count of a vertex is derived from the support
+// of its own edges. Intersections use edge_ids::intersect, which binary
+// searches the longer list when the degrees are skewed, so the work is
+// O(sum over edges of min(deg(u), deg(v)) log(max(deg(u), deg(v)))).
+
+// The number of triangles containing each edge, indexed by edge ID (both
+// copies of an undirected edge hold the same value).
+template <class W>
+inline sequence<uintE>
+TriangleEdgeSupport(symmetric_graph<symmetric_vertex, W> &G,
+                    const edge_ids<W> &ids) {
+    auto support = ids.edge_property((uintE)0);
+    auto noop = [](uintE w, uintT uw, uintT vw) {};
+    parallel_for(
+        0, G.n,
+        [&](size_t u) {
+            uintE deg = G.v_data[u].degree;
+            parallel_for(0, deg, [&](size_t i) {
+                uintT e = ids.id(u, i);
+                uintE v = ids.target(e);
+                if (u < v) {
+                    uintE s = ids.intersect(u, v, noop);
+                    support[e] = s;
+                    support[ids.reverse(e)] = s;
+                }
+            });
+        },
+        1);
+    return support;
+}
+
+// The number of triangles containing each vertex. Every triangle at u is
+// counted by the support of its two edges incident to u.
+template <class W>
+inline sequence<size_t>
+TriangleVertexCounts(symmetric_graph<symmetric_vertex, W> &G,
+                     const edge_ids<W> &ids, const sequence<uintE> &support) {
+    return sequence<size_t>(G.n, [&](size_t u) {
+        auto edge_support = pbbs::delayed_seq<size_t>(
+            G.v_data[u].degree,
+            [&](size_t i) { return (size_t)support[ids.id(u, i)]; });
+        return pbbslib::reduce_add(edge_support) / 2;
+    });
+}
+
+// The local clustering coefficient of each vertex: the fraction of pairs of
+// its neighbors that are adjacent, or 0 for vertices of degree below 2.
+template <class Graph>
+inline sequence<double>
+LocalClusteringCoefficient(Graph &G, const sequence<size_t> &counts) {
+    return sequence<double>(G.n, [&](size_t u) {
+        double deg = G.get_vertex(u).out_degree();
+        return (deg < 2) ? 0.0 : (2.0 * counts[u]) / (deg * (deg - 1));
+    });
+}
+
 template <class Graph, class F>
 inline size_t Triangle(Graph &G, const F &f, const std::string &ordering,
                        commandLine &P) {
@@ -4,6 +4,8 @@
 
 #include "gbbs/graph.h"
 #include "gbbs/pbbslib/sparse_table.h"
+#include "pbbslib/integer_sort.h"
+#include "pbbslib/monoid.h"
 #include "pbbslib/sequence_ops.h"
 
 namespace gbbs {
@@ -277,5 +279,128 @@ contract(Graph &GA, sequence<uintE> &clusters, size_t num_clusters) {
     return std::make_tuple(GC, std::move(flags), std::move(mapping));
 }
 
+// The sum of values[i] over the vertices i of each cluster, where clusters[i]
+// is in [0, num_clusters). The vertices are grouped by an integer sort rather
+// than with atomic adds, so large clusters do not cause contention.
+template <class T, class C, class V>
+inline sequence<T> cluster_sums(const C &clusters, size_t num_clusters,
+                                const V &values) {
+    size_t n = clusters.size();
+    auto order = sequence<uintE>(n, [&](size_t i) { return (uintE)i; });
+    auto get_cluster = [&](uintE v) -> size_t { return clusters[v]; };
+    pbbs::integer_sort_inplace(order.slice(), get_cluster,
+                               pbbslib::log2_up(num_clusters));
+    auto is_start = pbbs::delayed_seq<bool>(n, [&](size_t i) {
+        return i == 0 || clusters[order[i]] != clusters[order[i - 1]];
+    });
+    auto starts = pbbs::pack_index<size_t>(is_start);
+    auto sums = sequence<T>(num_clusters, (T)0);
+    parallel_for(
+        0, starts.size(),
+        [&](size_t i) {
+            size_t start = starts[i];
+            size_t end = (i + 1 == starts.size()) ? n : starts[i + 1];
+            auto vals = pbbs::delayed_seq<T>(end - start, [&](size_t j) {
+                return (T)values[order[start + j]];
+            });
+            sums[clusters[order[start]]] = pbbslib::reduce_add(vals);
+        },
+        1);
+    return sums;
+}
+
+// Weighted version of contract: given a graph and a vertex partitioning of the
+// graph, returns a contracted graph on `num_clusters` vertices where cluster i
+// is vertex i, and the parallel edges between two clusters are merged into a
+// single edge whose weight is the reduction, under `monoid` (e.g.
+// pbbs::addm, pbbs::minm or pbbs::maxm from pbbslib/monoid.h), of
+// `get_weight(w)` over those edges. Singleton clusters are kept as vertices
+// of degree zero, so cluster ids do not change.
+//
+// The edges are grouped with an integer sort on (cluster, cluster) rather
+// than a hash table, so the work is that of sorting the m edges regardless
+// of the number of clusters or how skewed they are.
+//
+// Returns:
+// (0) The contracted graph, with no self-loops.
+// (1) A `num_clusters`-length sequence whose i-th entry is the reduction of
+//   the weights of the edges inside cluster i (each undirected edge is taken
+//   once), or `monoid.identity` if there are none.
+template <class Monoid, class Graph, class C, class GetWeight>
+inline std::pair<symmetric_graph<symmetric_vertex, typename Monoid::T>,
+                 sequence<typename Monoid::T>>
+contract(Graph &GA, C &clusters, size_t num_clusters, GetWeight get_weight,
+         Monoid monoid) {
+    using W = typename Graph::weight_type;
+    using Wgh = typename Monoid::T;
+    using K = std::tuple<uintE, uintE, Wgh>;
+    size_t n = GA.n;
+
+    // Both directions of the inter-cluster edges, and one direction of the
+    // intra-cluster edges (which become self-loops).
+    auto keep = [&](const uintE &src, const uintE &ngh) {
+        return clusters[src] != clusters[ngh] || src <= ngh;
+    };
+    auto pred = [&](const uintE &src, const uintE &ngh, const W &w) {
+        return keep(src, ngh);
+    };
+    auto offsets = sequence<size_t>(n + 1, [&](size_t i) -> size_t {
+        return (i == n) ? 0 : GA.get_vertex(i).out_neighbors().count(pred);
+    });
+    size_t num_arcs = pbbslib::scan_add_inplace(offsets.slice());
+
+    auto arcs = sequence<K>(num_arcs);
+    parallel_for(
+        0, n,
+        [&](size_t i) {
+            size_t k = offsets[i];
+            auto map_f = [&](const uintE &src, const uintE &ngh, const W &w) {
+                if (keep(src, ngh)) {
+                    arcs[k++] = K(clusters[src], clusters[ngh], get_weight(w));
+                }
+            };
+            GA.get_vertex(i).out_neighbors().map(map_f, false);
+        },
+        1);
+    offsets.clear();
+
+    size_t bits = 2 * pbbslib::log2_up(num_clusters);
+    auto get_key = [&](const K &e) -> size_t {
+        return static_cast<size_t>(std::get<0>(e)) * num_clusters +
+               std::get<1>(e);
+    };
+    pbbs::integer_sort_inplace(arcs.slice(), get_key, bits);
+
+    auto is_start = pbbs::delayed_seq<bool>(num_arcs, [&](size_t i) {
+        return i == 0 || get_key(arcs[i]) != get_key(arcs[i - 1]);
+    });
+    auto starts = pbbs::pack_index<size_t>(is_start);
+    size_t num_groups = starts.size();
+    auto grouped = sequence<K>(num_groups, [&](size_t i) {
+        size_t start = starts[i];
+        size_t end = (i + 1 == num_groups) ? num_arcs : starts[i + 1];
+        auto weights = pbbs::delayed_seq<Wgh>(end - start, [&](size_t j) {
+            return std::get<2>(arcs[start + j]);
+        });
+        return K(std::get<0>(arcs[start]), std::get<1>(arcs[start]),
+                 pbbs::reduce(weights, monoid));
+    });
+    arcs.clear();
+
+    auto self_loops = sequence<Wgh>(num_clusters, monoid.identity);
+    parallel_for(0, num_groups, [&](size_t i) {
+        if (std::get<0>(grouped[i]) == std::get<1>(grouped[i])) {
+            self_loops[std::get<0>(grouped[i])] = std::get<2>(grouped[i]);
+        }
+    });
+    auto edges = pbbs::filter(grouped, [&](const K &e) {
+        return std::get<0>(e) != std::get<1>(e);
+    });
+    grouped.clear();
+    auto GC = sym_graph_from_edges<Wgh>(edges, num_clusters,
+                                        /* is_sorted = */ true);
+    return std::make_pair(GC, std::move(self_loops));
+}
+
 } // namespace contract
 } // namespace gbbs
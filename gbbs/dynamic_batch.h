@@ -0,0 +1,217 @@
+// Shared pieces of the batch-dynamic benchmarks (DynamicKCore and
+// DynamicTriangle): an undirected graph kept as sorted adjacency vectors that
+// applies batches of edge insertions and deletions, and the driver code that
+// samples the updates from the input graph and times them in batches.
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "gbbs/gbbs.h"
+#include "pbbslib/sample_sort.h"
+
+namespace gbbs {
+namespace dynamic_batch {
+
+using edge = std::pair<uintE, uintE>;
+
+// Both orientations of every edge, sorted.
+inline sequence<edge> directed(const sequence<edge> &E) {
+    auto both = sequence<edge>(2 * E.size(), [&](size_t i) {
+        auto &e = E[i / 2];
+        return (i & 1) ? edge(e.second, e.first) : e;
+    });
+    return pbbs::sample_sort(both, std::less<edge>());
+}
+
+// Offsets of the runs of edges with the same first endpoint, followed by
+// A.size().
+inline sequence<size_t> group_starts(const sequence<edge> &A) {
+    auto is_start = pbbs::delayed_seq<bool>(A.size(), [&](size_t i) {
+        return i == 0 || A[i].first != A[i - 1].first;
+    });
+    auto starts = pbbs::pack_index<size_t>(is_start);
+    auto out = sequence<size_t>(starts.size() + 1, [&](size_t i) {
+        return (i == starts.size()) ? A.size() : starts[i];
+    });
+    return out;
+}
+
+// An undirected graph kept as sorted adjacency vectors.
+struct adjacency_graph {
+    size_t n;
+    size_t m; // number of undirected edges
+    std::vector<std::vector<uintE>> adj;
+
+    // Starts from the subgraph of G containing the edges (u, v) for which
+    // keep(u, v) is true; keep must be symmetric.
+    template <class Graph, class Keep>
+    adjacency_graph(Graph &G, Keep keep) : n(G.n), adj(G.n) {
+        using W = typename Graph::weight_type;
+        parallel_for(
+            0, n,
+            [&](size_t u) {
+                auto map_f = [&](const uintE &u_, const uintE &v,
+                                 const W &wgh) {
+                    if (keep(u_, v)) {
+                        adj[u].push_back(v);
+                    }
+                };
+                G.get_vertex(u).out_neighbors().map(map_f, false);
+                std::sort(adj[u].begin(), adj[u].end());
+            },
+            1);
+        m = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+                n, [&](size_t u) { return adj[u].size(); })) /
+            2;
+    }
+
+    inline bool has_edge(uintE u, uintE v) const {
+        return std::binary_search(adj[u].begin(), adj[u].end(), v);
+    }
+
+    // Orients edges as (min, max), removes self-loops and duplicates, and
+    // keeps the edges that are present (or absent, if !present) in the graph.
+    sequence<edge> normalize(const sequence<edge> &batch, bool present) const {
+        auto oriented = sequence<edge>(batch.size(), [&](size_t i) {
+            uintE u = batch[i].first, v = batch[i].second;
+            return (u < v) ? edge(u, v) : edge(v, u);
+        });
+        auto sorted = pbbs::sample_sort(oriented, std::less<edge>());
+        auto keep = sequence<bool>(sorted.size(), [&](size_t i) {
+            auto &e = sorted[i];
+            return e.first != e.second && (i == 0 || sorted[i - 1] != e) &&
+                   has_edge(e.first, e.second) == present;
+        });
+        return pbbs::pack(sorted, keep);
+    }
+
+    // Adds the absent edges both (with both orientations, from directed) to
+    // the graph. A vertex can be an endpoint of several of them, so every
+    // adjacency vector is merged once with its run of new neighbors.
+    void add_edges(const sequence<edge> &both) {
+        auto starts = group_starts(both);
+        parallel_for(0, starts.size() - 1, [&](size_t g) {
+            auto &A = adj[both[starts[g]].first];
+            size_t old_size = A.size();
+            for (size_t j = starts[g]; j < starts[g + 1]; j++) {
+                A.push_back(both[j].second);
+            }
+            std::inplace_merge(A.begin(), A.begin() + old_size, A.end());
+        });
+        m += both.size() / 2;
+    }
+
+    // Removes the present edges both (with both orientations, from directed)
+    // from the graph, and returns the distinct endpoints of the edges.
+    sequence<uintE> remove_edges(const sequence<edge> &both) {
+        auto starts = group_starts(both);
+        parallel_for(0, starts.size() - 1, [&](size_t g) {
+            auto &A = adj[both[starts[g]].first];
+            size_t out = 0;
+            size_t j = starts[g];
+            for (size_t i = 0; i < A.size(); i++) {
+                while (j < starts[g + 1] && both[j].second < A[i]) {
+                    j++;
+                }
+                if (j < starts[g + 1] && both[j].second == A[i]) {
+                    continue;
+                }
+                A[out++] = A[i];
+            }
+            A.resize(out);
+        });
+        m -= both.size() / 2;
+        return sequence<uintE>(starts.size() - 1, [&](size_t g) {
+            return both[starts[g]].first;
+        });
+    }
+};
+
+// Samples an undirected edge as an update by hashing it to a double in
+// (0, 1), so the starting graph and the updates partition the input graph.
+struct update_sampler {
+    double update_pct;
+
+    explicit update_sampler(double update_pct) : update_pct(update_pct) {}
+
+    inline bool operator()(const uintE &u, const uintE &v) const {
+        size_t key = (static_cast<size_t>(std::min(u, v)) << 32UL) +
+                     static_cast<size_t>(std::max(u, v));
+        return static_cast<double>(pbbs::hash64(key)) /
+                   static_cast<double>(std::numeric_limits<size_t>::max()) <
+               update_pct;
+    }
+};
+
+// The sampled edges of the symmetric graph G, once each, in random order.
+template <class Graph>
+inline sequence<edge> sample_updates(Graph &G,
+                                     const update_sampler &is_update) {
+    using W = typename Graph::weight_type;
+    auto update_pred = [&](const uintE &u, const uintE &v, const W &wgh) {
+        return u < v && is_update(u, v);
+    };
+    auto sampled = sampleEdges(G, update_pred);
+    auto updates = sequence<edge>(sampled.m, [&](size_t i) {
+        return edge(std::get<0>(sampled.E[i]), std::get<1>(sampled.E[i]));
+    });
+    sampled.del();
+    return pbbs::random_shuffle(updates);
+}
+
+// Inserts (or deletes) the updates into D in batches of batch_size edges, and
+// returns the time taken by each batch.
+template <class Dynamic>
+inline std::vector<double> run_phase(Dynamic &D, const sequence<edge> &updates,
+                                     size_t batch_size, bool insert) {
+    std::vector<double> times;
+    for (size_t s = 0; s < updates.size(); s += batch_size) {
+        size_t e = std::min(s + batch_size, updates.size());
+        auto batch =
+            sequence<edge>(e - s, [&](size_t i) { return updates[s + i]; });
+        timer bt;
+        bt.start();
+        if (insert) {
+            D.InsertEdges(batch);
+        } else {
+            D.DeleteEdges(batch);
+        }
+        times.push_back(bt.stop());
+    }
+    return times;
+}
+
+inline void report_phase(const std::string &name,
+                         const std::vector<double> &times,
+                         size_t num_updates) {
+    auto sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (double t : times)
+        total += t;
+    std::cout << "Test = {"
+              << "\"name\": \"" << name << "\"" << std::setprecision(5)
+              << ", \"batches\":" << times.size() << ", \"time\":" << total
+              << ", \"med_batch_time\":" << sorted[sorted.size() / 2]
+              << ", \"min_batch_time\":" << sorted.front()
+              << ", \"max_batch_time\":" << sorted.back()
+              << ", \"throughput\":" << num_updates / total << "}"
+              << std::endl;
+}
+
+// Compares the values maintained by a dynamic benchmark with the values
+// computed from scratch, and prints the number of vertices that differ.
+template <class Exact, class Maintained>
+inline size_t verify_values(const Exact &exact, const Maintained &maintained) {
+    size_t mismatches = pbbslib::reduce_add(pbbs::delayed_seq<size_t>(
+        exact.size(),
+        [&](size_t i) { return (size_t)(exact[i] != maintained[i]); }));
+    std::cout << "### Verification: mismatches = " << mismatches << std::endl;
+    return mismatches;
+}
+
+} // namespace dynamic_batch
+} // namespace gbbs
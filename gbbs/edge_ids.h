@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "graph.h"
+
+namespace gbbs {
+
+// Edge IDs for an uncompressed symmetric graph. The ID of an edge is its
+// position in the CSR edge array: the i-th neighbor of u has ID
+// v_data[u].offset + i, so IDs are dense in [0, m) and per-edge data can be
+// kept in a flat array of size m (see edge_property). The IDs are only valid
+// while the adjacency lists are neither filtered nor packed.
+//
+// Every undirected edge {u, v} is stored twice, once in each endpoint's list.
+// reverse(e) gives the ID of the other copy in O(1); it is computed once at
+// construction by binary searching the (sorted) neighbor lists. Data for an
+// undirected edge can be kept at canonical(e), the copy stored at the smaller
+// endpoint.
+template <class W> struct edge_ids {
+    using Graph = symmetric_graph<symmetric_vertex, W>;
+    static constexpr uintT kNone = std::numeric_limits<uintT>::max();
+
+    Graph &G;
+    sequence<uintT> reverse_;
+
+    explicit edge_ids(Graph &G) : G(G) {
+        reverse_ = sequence<uintT>(G.m);
+        parallel_for(
+            0, G.n,
+            [&](size_t u) {
+                uintT off = G.v_data[u].offset;
+                uintE deg = G.v_data[u].degree;
+                parallel_for(0, deg, [&](size_t i) {
+                    reverse_[off + i] = find(target(off + i), u);
+                });
+            },
+            1);
+    }
+
+    // The ID of the i-th edge of u.
+    inline uintT id(uintE u, uintE i) const { return G.v_data[u].offset + i; }
+
+    inline uintE source(uintT e) const {
+        auto it = std::upper_bound(
+            G.v_data, G.v_data + G.n, e,
+            [](uintT e_, const vertex_data &d) { return e_ < d.offset; });
+        return (uintE)((it - G.v_data) - 1);
+    }
+    inline uintE target(uintT e) const { return std::get<0>(G.e0[e]); }
+    inline W weight(uintT e) const { return std::get<1>(G.e0[e]); }
+
+    inline uintT reverse(uintT e) const { return reverse_[e]; }
+    inline uintT canonical(uintT e) const { return std::min(e, reverse_[e]); }
+
+    // The ID of the edge (u, v), or kNone if there is no such edge. Takes
+    // O(log deg(u)) time.
+    inline uintT find(uintE u, uintE v) const {
+        auto nghs = G.e0 + G.v_data[u].offset;
+        auto end = nghs + G.v_data[u].degree;
+        auto it = std::lower_bound(
+            nghs, end, v, [](const std::tuple<uintE, W> &a, uintE b) {
+                return std::get<0>(a) < b;
+            });
+        if (it == end || std::get<0>(*it) != v) {
+            return kNone;
+        }
+        return G.v_data[u].offset + (it - nghs);
+    }
+
+    // Calls f(w, uw, vw) for every common neighbor w of u and v, where uw and
+    // vw are the IDs of (u, w) and (v, w). Merges the two lists, or binary
+    // searches the longer list for each neighbor in the shorter one when
+    // their lengths differ by more than kSearchRatio.
+    static constexpr size_t kSearchRatio = 32;
+    template <class F> inline size_t intersect(uintE u, uintE v, F f) const {
+        uintE du = G.v_data[u].degree;
+        uintE dv = G.v_data[v].degree;
+        if ((size_t)du * kSearchRatio < dv) {
+            return search_intersect(u, v, f, false);
+        } else if ((size_t)dv * kSearchRatio < du) {
+            return search_intersect(v, u, f, true);
+        }
+        uintT i = G.v_data[u].offset, end_i = i + du;
+        uintT j = G.v_data[v].offset, end_j = j + dv;
+        size_t ct = 0;
+        while (i < end_i && j < end_j) {
+            uintE a = target(i);
+            uintE b = target(j);
+            if (a == b) {
+                f(a, i, j);
+                i++, j++, ct++;
+            } else if (a < b) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+        return ct;
+    }
+
+  private:
+    // Intersection for a short list (of a) and a long one (of b).
+    template <class F>
+    inline size_t search_intersect(uintE a, uintE b, F &f, bool swapped) const {
+        uintT i = G.v_data[a].offset, end_i = i + G.v_data[a].degree;
+        size_t ct = 0;
+        for (; i < end_i; i++) {
+            uintE w = target(i);
+            uintT j = find(b, w);
+            if (j != kNone) {
+                swapped ? f(w, j, i) : f(w, i, j);
+                ct++;
+            }
+        }
+        return ct;
+    }
+
+  public:
+    // A flat array holding one T per edge ID.
+    template <class T> inline sequence<T> edge_property(T init) const {
+        return sequence<T>(G.m, init);
+    }
+};
+
+template <class W>
+inline edge_ids<W> make_edge_ids(symmetric_graph<symmetric_vertex, W> &G) {
+    return edge_ids<W>(G);
+}
+
+} // namespace gbbs
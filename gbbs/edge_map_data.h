@@ -160,25 +160,23 @@ inline vertexSubsetData<Data> edgeMapDenseForward(Graph &GA, VS &vertexSubset,
     }
 }
 
+// The kind of step edgeMapData takes over a vertex_subset.
+enum class edge_map_step { empty, dense, sparse };
+
 // Decides on sparse or dense base on number of nonzeros in the active vertices.
-template <
-    class Data /* data associated with vertices in the output vertex_subset */,
-    class Graph /* graph type */, class VS /* vertex_subset type */,
-    class F /* edgeMap struct */>
-inline vertexSubsetData<Data>
-edgeMapData(Graph &GA, VS &vs, F f, intT threshold = -1,
-            const flags &fl = 0) { // pass stringstream pointer????
+// As a side effect the degree sum of vs is cached on vs.
+template <class Graph /* graph type */, class VS /* vertex_subset type */>
+inline edge_map_step get_edge_map_step(Graph &GA, VS &vs, intT threshold = -1,
+                                       const flags &fl = 0) {
     size_t numVertices = GA.n, numEdges = GA.m, m = vs.numNonzeros();
     size_t dense_threshold = threshold;
     if (threshold == -1)
         dense_threshold = numEdges / 20;
     if (vs.size() == 0)
-        return vertexSubsetData<Data>(numVertices);
+        return edge_map_step::empty;
 
     if (vs.isDense && vs.size() > numVertices / 10) {
-        return (fl & dense_forward)
-                   ? edgeMapDenseForward<Data, Graph, VS, F>(GA, vs, f, fl)
-                   : edgeMapDense<Data, Graph, VS, F>(GA, vs, f, fl);
+        return edge_map_step::dense;
     }
 
     size_t out_degrees = 0;
@@ -196,18 +194,35 @@ edgeMapData(Graph &GA, VS &vs, F f, intT threshold = -1,
     }
 
     if (out_degrees == 0)
-        return vertexSubsetData<Data>(numVertices);
+        return edge_map_step::empty;
     if (m + out_degrees > dense_threshold && !(fl & no_dense)) {
+        return edge_map_step::dense;
+    }
+    return edge_map_step::sparse;
+}
+
+template <
+    class Data /* data associated with vertices in the output vertex_subset */,
+    class Graph /* graph type */, class VS /* vertex_subset type */,
+    class F /* edgeMap struct */>
+inline vertexSubsetData<Data>
+edgeMapData(Graph &GA, VS &vs, F f, intT threshold = -1,
+            const flags &fl = 0) { // pass stringstream pointer????
+    switch (get_edge_map_step(GA, vs, threshold, fl)) {
+    case edge_map_step::empty:
+        return vertexSubsetData<Data>(GA.n);
+    case edge_map_step::dense:
         vs.toDense();
         return (fl & dense_forward)
                    ? edgeMapDenseForward<Data, Graph, VS, F>(GA, vs, f, fl)
                    : edgeMapDense<Data, Graph, VS, F>(GA, vs, f, fl);
-    } else {
+    default: {
         auto vs_out = edgeMapChunked<Data, Graph, VS, F>(GA, vs, f, fl);
         //    auto vs_out = edgeMapBlocked<Data, Graph, VS, F>(GA, vs, f, fl);
         //    auto vs_out = edgeMapSparse<Data, Graph, VS, F>(GA, vs, f, fl);
         return vs_out;
     }
+    }
 }
 
 // Regular edgeMap, where no extra data is stored per vertex.
@@ -168,6 +168,32 @@ read_unweighted_asymmetric_graph(const char *fname, bool mmap, char *bytes,
         (std::tuple<uintE, pbbs::empty> *)inEdges);
 }
 
+asymmetric_graph<asymmetric_vertex, pbbslib::empty>
+read_unweighted_asymmetric_out_graph(const char *fname, bool mmap, char *bytes,
+                                     size_t bytes_size) {
+    size_t n, m;
+    uintT *offsets;
+    uintE *edges;
+    std::tie(n, m, offsets, edges) =
+        parse_unweighted_graph(fname, mmap, bytes, bytes_size);
+
+    auto v_data = pbbs::new_array_no_init<vertex_data>(n);
+    auto v_in_data = pbbs::new_array_no_init<vertex_data>(n);
+    parallel_for(0, n, [&](size_t i) {
+        v_data[i].offset = offsets[i];
+        v_data[i].degree = offsets[i + 1] - v_data[i].offset;
+        v_in_data[i].offset = 0;
+        v_in_data[i].degree = 0;
+    });
+    pbbs::free_array(offsets);
+
+    return asymmetric_graph<asymmetric_vertex, pbbs::empty>(
+        v_data, v_in_data, n, m,
+        [=]() { pbbslib::free_arrays(v_data, v_in_data, edges); },
+        (std::tuple<uintE, pbbs::empty> *)edges,
+        (std::tuple<uintE, pbbs::empty> *)edges);
+}
+
 std::tuple<char *, size_t> parse_compressed_graph(const char *fname, bool mmap,
                                                   bool mmapcopy) {
     char *bytes;
@@ -104,6 +104,15 @@ read_unweighted_asymmetric_graph(
     const char *fname, bool mmap, char *bytes = nullptr,
     size_t bytes_size = std::numeric_limits<size_t>::max());
 
+/* Reads only the out-edges of an asymmetric graph. The returned graph reports
+ * an in-degree of zero for every vertex until its transpose is materialized
+ * (see gbbs/lazy_transpose.h), which avoids storing the in-edges for
+ * algorithms that rarely (or never) traverse them. */
+asymmetric_graph<asymmetric_vertex, pbbslib::empty>
+read_unweighted_asymmetric_out_graph(
+    const char *fname, bool mmap, char *bytes = nullptr,
+    size_t bytes_size = std::numeric_limits<size_t>::max());
+
 std::tuple<char *, size_t> parse_compressed_graph(const char *fname, bool mmap,
                                                   bool mmapcopy);
 
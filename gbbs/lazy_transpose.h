@@ -0,0 +1,204 @@
+// Lazily materialized transposes (in-edges) for asymmetric graphs.
+//
+// Direction-optimizing traversals only need the in-edges of an asymmetric
+// graph once they choose a dense (pull-based) step. For graphs read with
+// gbbs_io::read_unweighted_asymmetric_out_graph, lazy_transpose builds the
+// in-edges in parallel the first time such a step is chosen, and can persist
+// them to a cache file that later runs mmap instead of rebuilding.
+//
+// Cache file layout (all fields native-endian):
+//   transpose_cache_header
+//   uintT in_offsets[n + 1]
+//   edge_type in_edges[m]
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+#include "gbbs/graph.h"
+#include "gbbs/io.h"
+#include "gbbs/edge_map_data.h"
+#include "gbbs/macros.h"
+#include "gbbs/vertex_subset.h"
+
+namespace gbbs {
+
+struct transpose_cache_header {
+    uint64_t magic;
+    uint64_t n;
+    uint64_t m;
+    uint64_t edge_bytes; // sizeof(edge_type) of the graph that wrote the cache
+};
+
+// "gbbsTRN1" in ASCII.
+constexpr uint64_t kTransposeCacheMagic = 0x314e525473626267ULL;
+
+// Returns true if edgeMapData (called with the same threshold and flags) will
+// read the in-edges of the graph: by default its dense step pulls over them,
+// and with in_edges its sparse step maps over them (and its dense step pulls
+// over the out-edges). dense_forward never reads them.
+template <class Graph, class VS>
+inline bool edge_map_uses_in_edges(Graph &G, VS &vs, intT threshold = -1,
+                                   const flags &fl = 0) {
+    if (fl & dense_forward) {
+        return false;
+    }
+    if (fl & in_edges) {
+        // The choice of a sparse step sums the in-degrees of vs, which are
+        // zero until the in-edges are materialized (and the sum is cached on
+        // vs), so only the size test that picks a dense step is applied.
+        return vs.size() > 0 && !(vs.isDense && vs.size() > G.n / 10);
+    }
+    return get_edge_map_step(G, vs, threshold, fl) == edge_map_step::dense;
+}
+
+template <class W> struct lazy_transpose {
+    using graph = asymmetric_graph<asymmetric_vertex, W>;
+    using edge_type = typename graph::edge_type;
+
+    graph &G;
+    // If non-empty, the transpose is loaded from (or saved to) this file.
+    std::string cache_file;
+    bool materialized;
+
+    lazy_transpose(graph &G, std::string cache_file = "")
+        : G(G), cache_file(cache_file), materialized(false) {}
+
+    // Materializes the in-edges of G if the next edgeMap over vs (with the
+    // given threshold and flags) will need them.
+    template <class VS>
+    void prepare(VS &vs, intT threshold = -1, const flags &fl = 0) {
+        if (!materialized && edge_map_uses_in_edges(G, vs, threshold, fl)) {
+            materialize();
+        }
+    }
+
+    void materialize() {
+        if (materialized) {
+            return;
+        }
+        timer t;
+        t.start();
+        if (!cache_file.empty() && load_cache()) {
+            debug(std::cout << "# loaded transpose from " << cache_file
+                            << " in " << t.stop() << "\n";);
+        } else {
+            build();
+            debug(std::cout << "# built transpose in " << t.stop() << "\n";);
+            if (!cache_file.empty()) {
+                write_cache();
+            }
+        }
+        materialized = true;
+    }
+
+  private:
+    // Builds the in-edges by integer-sorting the reversed out-edges. In-edge
+    // lists are sorted by source id since the sort is stable.
+    void build() {
+        using edge = std::tuple<uintE, uintE, W>;
+        size_t n = G.n;
+        auto offsets = sequence<uintT>(
+            n, [&](size_t i) { return G.get_vertex(i).out_degree(); });
+        size_t m = pbbslib::scan_add_inplace(offsets.slice());
+        auto A = sequence<edge>(m);
+        parallel_for(
+            0, n,
+            [&](size_t i) {
+                size_t o = offsets[i];
+                auto map_f = [&](const uintE &u, const uintE &v, const W &wgh,
+                                 size_t j) {
+                    A[o + j] = std::make_tuple(v, u, wgh);
+                };
+                G.get_vertex(i).out_neighbors().map_with_index(map_f, false);
+            },
+            1);
+        auto get_u = [&](const edge &e) { return std::get<0>(e); };
+        auto get_v = [&](const edge &e) { return std::get<1>(e); };
+        auto get_w = [&](const edge &e) { return std::get<2>(e); };
+        pbbslib::integer_sort_inplace(A.slice(), get_u, pbbslib::log2_up(n));
+
+        auto starts = sequence<uintT>(n + 1, (uintT)0);
+        auto in_edges = get_edges<W>(A, starts, m, get_u, get_v, get_w);
+        A.clear();
+        parallel_for(0, n, [&](size_t i) {
+            G.v_in_data[i].offset = starts[i];
+            G.v_in_data[i].degree = (uintE)(starts[i + 1] - starts[i]);
+        });
+        auto in_edges_arr = (edge_type *)in_edges.to_array();
+        install(in_edges_arr, [in_edges_arr]() {
+            pbbslib::free_array(in_edges_arr);
+        });
+    }
+
+    bool load_cache() {
+        struct stat sb;
+        if (stat(cache_file.c_str(), &sb) == -1) {
+            return false;
+        }
+        size_t n = G.n, m = G.m;
+        size_t expected = sizeof(transpose_cache_header) +
+                          (n + 1) * sizeof(uintT) + m * sizeof(edge_type);
+        if ((size_t)sb.st_size != expected) {
+            std::cout << "# ignoring transpose cache " << cache_file
+                      << ": unexpected size" << std::endl;
+            return false;
+        }
+        char *bytes;
+        size_t bytes_size;
+        std::tie(bytes, bytes_size) =
+            gbbs_io::mmapStringFromFile(cache_file.c_str());
+        auto header = (transpose_cache_header *)bytes;
+        if (header->magic != kTransposeCacheMagic || header->n != n ||
+            header->m != m || header->edge_bytes != sizeof(edge_type)) {
+            std::cout << "# ignoring transpose cache " << cache_file
+                      << ": header does not match the graph" << std::endl;
+            gbbs_io::unmmap(bytes, bytes_size);
+            return false;
+        }
+        auto in_offsets =
+            (uintT *)(bytes + sizeof(transpose_cache_header));
+        auto in_edges_arr = (edge_type *)(in_offsets + (n + 1));
+        parallel_for(0, n, [&](size_t i) {
+            G.v_in_data[i].offset = in_offsets[i];
+            G.v_in_data[i].degree = (uintE)(in_offsets[i + 1] - in_offsets[i]);
+        });
+        install(in_edges_arr,
+                [bytes, bytes_size]() { gbbs_io::unmmap(bytes, bytes_size); });
+        return true;
+    }
+
+    void write_cache() {
+        size_t n = G.n, m = G.m;
+        std::ofstream out(cache_file, std::ios::out | std::ios::binary);
+        if (!out.is_open()) {
+            std::cout << "# unable to write transpose cache " << cache_file
+                      << std::endl;
+            return;
+        }
+        transpose_cache_header header = {kTransposeCacheMagic, n, m,
+                                         sizeof(edge_type)};
+        auto in_offsets = sequence<uintT>(n + 1, [&](size_t i) {
+            return (i == n) ? (uintT)m : (uintT)G.v_in_data[i].offset;
+        });
+        out.write((char *)&header, sizeof(header));
+        out.write((char *)in_offsets.begin(), (n + 1) * sizeof(uintT));
+        out.write((char *)G.in_edges_0, m * sizeof(edge_type));
+        out.close();
+    }
+
+    // Points G at the new in-edges, and chains the function releasing them
+    // onto G's deletion function.
+    template <class D> void install(edge_type *in_edges_arr, D release) {
+        G.in_edges_0 = in_edges_arr;
+        G.in_edges_1 = in_edges_arr;
+        auto deletion_fn = G.deletion_fn;
+        G.deletion_fn = [deletion_fn, release]() {
+            deletion_fn();
+            release();
+        };
+    }
+};
+
+} // namespace gbbs
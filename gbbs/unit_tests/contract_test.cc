@@ -0,0 +1,135 @@
+#include "gbbs/contract.h"
+
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "gbbs/graph.h"
+#include "pbbslib/monoid.h"
+#include "pbbslib/seq.h"
+#include <gtest/gtest.h>
+
+namespace gbbs {
+
+namespace {
+
+using edge = std::tuple<uintE, uintE, int>;
+
+// A symmetric graph with both directions of each undirected edge in `edges`,
+// except that a self-loop (v, v, w) is stored once in v's neighbor list.
+symmetric_graph<symmetric_vertex, int>
+MakeWeightedSymmetricGraph(size_t n, const std::vector<edge> &edges) {
+    std::vector<edge> arcs;
+    for (const auto &e : edges) {
+        arcs.push_back(e);
+        if (std::get<0>(e) != std::get<1>(e)) {
+            arcs.push_back(std::make_tuple(std::get<1>(e), std::get<0>(e),
+                                           std::get<2>(e)));
+        }
+    }
+    auto A = pbbs::sequence<edge>(arcs.size(),
+                                  [&](size_t i) { return arcs[i]; });
+    return sym_graph_from_edges(A, n, /* is_sorted = */ false);
+}
+
+// The neighbors of v in G, with their weights, in order.
+template <class Graph>
+std::vector<std::tuple<uintE, int>> Neighbors(Graph &G, uintE v) {
+    std::vector<std::tuple<uintE, int>> neighbors;
+    auto map_f = [&](const uintE &u, const uintE &ngh, const int &w) {
+        neighbors.push_back(std::make_tuple(ngh, w));
+    };
+    G.get_vertex(v).out_neighbors().map(map_f, false);
+    return neighbors;
+}
+
+// Clusters {0, 1, 2}, {3, 4}, {5} and {6}. Cluster 0 has two intra-cluster
+// edges and a self-loop, and three edges to cluster 1; vertex 5 has only a
+// self-loop and vertex 6 is isolated.
+const std::vector<edge> kEdges{
+    {0, 1, 1}, {1, 2, 2}, {0, 0, 10}, {0, 3, 4},
+    {1, 3, 5}, {2, 4, 6}, {3, 4, 7},  {5, 5, 8},
+};
+constexpr size_t kNumVertices{7};
+constexpr size_t kNumClusters{4};
+
+pbbs::sequence<uintE> MakeClusters() {
+    const std::vector<uintE> cluster_of{0, 0, 0, 1, 1, 2, 3};
+    return pbbs::sequence<uintE>(kNumVertices,
+                                 [&](size_t i) { return cluster_of[i]; });
+}
+
+auto get_weight = [](const int &w) { return w; };
+
+} // namespace
+
+TEST(ContractWeighted, AddMonoid) {
+    auto G = MakeWeightedSymmetricGraph(kNumVertices, kEdges);
+    auto clusters = MakeClusters();
+    auto result = contract::contract(G, clusters, kNumClusters, get_weight,
+                                     pbbs::addm<int>());
+    auto &GC = result.first;
+    auto &self_loops = result.second;
+
+    // The three edges between clusters 0 and 1 become one edge of weight
+    // 4 + 5 + 6 in each direction.
+    ASSERT_EQ(GC.n, kNumClusters);
+    EXPECT_EQ(GC.m, 2);
+    EXPECT_EQ(Neighbors(GC, 0),
+              (std::vector<std::tuple<uintE, int>>{{1, 15}}));
+    EXPECT_EQ(Neighbors(GC, 1),
+              (std::vector<std::tuple<uintE, int>>{{0, 15}}));
+    // Singleton clusters stay as vertices of degree zero.
+    EXPECT_EQ(GC.get_vertex(2).out_degree(), 0);
+    EXPECT_EQ(GC.get_vertex(3).out_degree(), 0);
+
+    // Each intra-cluster edge, including a real self-loop, is counted once.
+    ASSERT_EQ(self_loops.size(), kNumClusters);
+    EXPECT_EQ(self_loops[0], 1 + 2 + 10);
+    EXPECT_EQ(self_loops[1], 7);
+    EXPECT_EQ(self_loops[2], 8);
+    EXPECT_EQ(self_loops[3], 0);
+    GC.del();
+}
+
+TEST(ContractWeighted, MinMonoid) {
+    auto G = MakeWeightedSymmetricGraph(kNumVertices, kEdges);
+    auto clusters = MakeClusters();
+    auto result = contract::contract(G, clusters, kNumClusters, get_weight,
+                                     pbbs::minm<int>());
+    auto &GC = result.first;
+    auto &self_loops = result.second;
+
+    ASSERT_EQ(GC.n, kNumClusters);
+    EXPECT_EQ(GC.m, 2);
+    EXPECT_EQ(Neighbors(GC, 0), (std::vector<std::tuple<uintE, int>>{{1, 4}}));
+    EXPECT_EQ(Neighbors(GC, 1), (std::vector<std::tuple<uintE, int>>{{0, 4}}));
+    EXPECT_EQ(GC.get_vertex(2).out_degree(), 0);
+    EXPECT_EQ(GC.get_vertex(3).out_degree(), 0);
+
+    ASSERT_EQ(self_loops.size(), kNumClusters);
+    EXPECT_EQ(self_loops[0], 1);
+    EXPECT_EQ(self_loops[1], 7);
+    EXPECT_EQ(self_loops[2], 8);
+    // A cluster without intra-cluster edges gets the identity.
+    EXPECT_EQ(self_loops[3], std::numeric_limits<int>::max());
+    GC.del();
+}
+
+TEST(ContractWeighted, SingleCluster) {
+    auto G = MakeWeightedSymmetricGraph(kNumVertices, kEdges);
+    auto clusters = pbbs::sequence<uintE>(kNumVertices, (uintE)0);
+    auto result =
+        contract::contract(G, clusters, 1, get_weight, pbbs::addm<int>());
+    auto &GC = result.first;
+    auto &self_loops = result.second;
+
+    ASSERT_EQ(GC.n, 1);
+    EXPECT_EQ(GC.m, 0);
+    EXPECT_EQ(GC.get_vertex(0).out_degree(), 0);
+    ASSERT_EQ(self_loops.size(), 1);
+    EXPECT_EQ(self_loops[0], 1 + 2 + 10 + 4 + 5 + 6 + 7 + 8);
+    GC.del();
+}
+
+} // namespace gbbs
@@ -0,0 +1,53 @@
+#include "gbbs/edge_ids.h"
+#include "pbbslib/seq.h"
+#include <gtest/gtest.h>
+
+namespace gbbs {
+
+TEST(TestEdgeIds, TestTriangleWithPendant) {
+    // Graph diagram:
+    // 0 -- 1 -- 3    4
+    //  \  /
+    //   2
+    using edge = std::tuple<uintE, uintE, int>;
+    const uintE n = 5;
+    pbbs::sequence<edge> edges(8);
+    edges[0] = std::make_tuple(0, 1, 1);
+    edges[1] = std::make_tuple(1, 0, 1);
+    edges[2] = std::make_tuple(0, 2, 1);
+    edges[3] = std::make_tuple(2, 0, 1);
+    edges[4] = std::make_tuple(1, 2, 1);
+    edges[5] = std::make_tuple(2, 1, 1);
+    edges[6] = std::make_tuple(1, 3, 1);
+    edges[7] = std::make_tuple(3, 1, 1);
+    auto G = sym_graph_from_edges(edges, n);
+    auto ids = make_edge_ids(G);
+
+    for (uintT e = 0; e < G.m; e++) {
+        uintT r = ids.reverse(e);
+        ASSERT_EQ(ids.reverse(r), e);
+        ASSERT_EQ(ids.source(r), ids.target(e));
+        ASSERT_EQ(ids.target(r), ids.source(e));
+        ASSERT_EQ(ids.canonical(e), ids.canonical(r));
+        ASSERT_LT(ids.source(ids.canonical(e)), ids.target(ids.canonical(e)));
+    }
+    // Vertex 4 has no edges, so 3's edge has the last ID.
+    ASSERT_EQ(ids.source(G.m - 1), 3);
+    ASSERT_EQ(ids.find(1, 3), ids.id(1, 2));
+    ASSERT_EQ(ids.find(0, 3), edge_ids<int>::kNone);
+    ASSERT_EQ(ids.find(4, 0), edge_ids<int>::kNone);
+
+    size_t common = ids.intersect(0, 1, [&](uintE w, uintT uw, uintT vw) {
+        ASSERT_EQ(w, 2);
+        ASSERT_EQ(uw, ids.find(0, 2));
+        ASSERT_EQ(vw, ids.find(1, 2));
+    });
+    ASSERT_EQ(common, 1);
+    ASSERT_EQ(ids.intersect(1, 4, [](uintE, uintT, uintT) {}), 0);
+
+    auto count = ids.edge_property<int>(0);
+    ASSERT_EQ(count.size(), G.m);
+    G.del();
+}
+
+} // namespace gbbs
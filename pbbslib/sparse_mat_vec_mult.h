@@ -4,12 +4,16 @@
 #include "utilities.h"
 
 namespace pbbs {
-// multiply a compresses sparse row matrix
-template <class IntSeq, class Seq, class Mult, class Add>
-void mat_vec_mult(IntSeq const &starts, IntSeq const &columns,
-                  Seq const &values, Seq const &in,
-                  range<typename Seq::value_type *> out, Mult mult, Add add) {
-    using E = typename Seq::value_type;
+// For every row i of a compressed sparse row matrix, calls apply(i, sum) with
+// the (mult, add)-product of the row and in, or with zero for empty rows.
+// Rows are processed in parallel, each one exactly once; apply may write to
+// in, in which case rows processed later see the new values (as in a
+// Gauss-Seidel sweep).
+template <class StartSeq, class ColSeq, class ValSeq, class InSeq, class E,
+          class Mult, class Add, class Apply>
+void mat_vec_mult_apply(StartSeq const &starts, ColSeq const &columns,
+                        ValSeq const &values, InSeq const &in, E zero,
+                        Mult mult, Add add, Apply apply) {
     size_t n = in.size();
     auto row_f = [&](size_t i) {
         size_t s = starts[i];
@@ -18,10 +22,21 @@ void mat_vec_mult(IntSeq const &starts, IntSeq const &columns,
             E sum = mult(in[columns[s]], values[s]);
             for (size_t j = s + 1; j < e; j++)
                 sum = add(sum, mult(in[columns[j]], values[j]));
-            out[i] = sum;
+            apply(i, sum);
         } else
-            out[i] = 0;
+            apply(i, zero);
     };
     parallel_for(0, n, row_f, pbbs::granularity(n));
 }
+
+// multiply a compresses sparse row matrix
+template <class StartSeq, class ColSeq, class ValSeq, class Seq, class Mult,
+          class Add>
+void mat_vec_mult(StartSeq const &starts, ColSeq const &columns,
+                  ValSeq const &values, Seq const &in,
+                  range<typename Seq::value_type *> out, Mult mult, Add add) {
+    using E = typename Seq::value_type;
+    mat_vec_mult_apply(starts, columns, values, in, (E)0, mult, add,
+                       [&](size_t i, E sum) { out[i] = sum; });
+}
 } // namespace pbbs
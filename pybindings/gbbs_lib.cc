@@ -12,6 +12,7 @@
 #include "benchmarks/KCore/JulienneDBS17/KCore.h"
 #include "benchmarks/CoSimRank/CoSimRank.h"
 #include "benchmarks/StronglyConnectedComponents/RandomGreedyBGSS16/StronglyConnectedComponents.h"
+#include "benchmarks/TriangleCounting/ShunTangwongsan15/Triangle.h"
 
 #include "pybind11/pybind11.h"
 #include "pybind11/numpy.h"
@@ -49,6 +50,30 @@ auto wrap_array(E* arr, size_t n) {
       free_when_done); // numpy array references this parent
 }
 
+/* Per-vertex triangle counts; local triangle statistics need edge IDs, which
+ * only uncompressed graphs have */
+template <class W>
+sequence<size_t> TriangleCounts(symmetric_graph<symmetric_vertex, W>& G) {
+  auto ids = make_edge_ids(G);
+  auto support = TriangleEdgeSupport(G, ids);
+  return TriangleVertexCounts(G, ids, support);
+}
+template <class Graph>
+sequence<size_t> TriangleCounts(Graph& G) {
+  throw std::runtime_error("local triangle counts require an uncompressed graph");
+}
+
+/* Triangle support of every edge, in the order of the CSR edge array */
+template <class W>
+sequence<uintE> TriangleSupport(symmetric_graph<symmetric_vertex, W>& G) {
+  auto ids = make_edge_ids(G);
+  return TriangleEdgeSupport(G, ids);
+}
+template <class Graph>
+sequence<uintE> TriangleSupport(Graph& G) {
+  throw std::runtime_error("edge support requires an uncompressed graph");
+}
+
 /* Defines symmetric graph functions */
 template <template <class W> class vertex_type, class W>
 void SymGraphRegister(py::module& m, std::string graph_name) {
@@ -75,6 +100,26 @@ void SymGraphRegister(py::module& m, std::string graph_name) {
       uintE* arr = cores.to_array();
       return wrap_array(arr, G.n);
     })
+    .def("TriangleCount", [&] (graph& G) {
+      auto f = [&] (uintE u, uintE v, uintE w) { };
+      return Triangle_degree_ordering(G, f);
+    })
+    .def("TriangleVertexCounts", [&] (graph& G) {
+      auto counts = TriangleCounts(G);
+      size_t* arr = counts.to_array();
+      return wrap_array(arr, G.n);
+    })
+    .def("TriangleEdgeSupport", [&] (graph& G) {
+      auto support = TriangleSupport(G);
+      uintE* arr = support.to_array();
+      return wrap_array(arr, G.m);
+    })
+    .def("LocalClusteringCoefficient", [&] (graph& G) {
+      auto counts = TriangleCounts(G);
+      auto lcc = LocalClusteringCoefficient(G, counts);
+      double* arr = lcc.to_array();
+      return wrap_array(arr, G.n);
+    })
     .def("CoSimRank", [&] (graph& G, const size_t src, const size_t dest) {
       CoSimRank(G, src, dest);
       return 1.0;